@@ -117,6 +117,18 @@
         <source>checkForUpdates</source>
         <translation>Check for updates</translation>
     </message>
+    <message>
+        <source>commandLineOptionTrace</source>
+        <translation>record startup spans and write them as a Chrome trace in the logs folder</translation>
+    </message>
+    <message>
+        <source>commandLineOptionModelStats</source>
+        <translation>count the signals and the filter/sort time of the list models and write them in the logs every &lt;seconds&gt; (0: only with the dump-model-stats command)</translation>
+    </message>
+    <message>
+        <source>commandLineOptionModelStatsArg</source>
+        <translation>seconds</translation>
+    </message>
 </context>
 <context>
     <name>AssistantAbstractView</name>
@@ -689,6 +701,18 @@ Server URL not configured.</translation>
         <source>joinConferenceAsFunctionDescription</source>
         <translation>Join the conference hosted by the sip-address as with the guest-sip-address. If you are not connected to a proxy-config, see join-conference.</translation>
     </message>
+    <message>
+        <source>dumpTraceFunctionDescription</source>
+        <translation>Write the spans recorded since startup in the Chrome trace format. The application must have been started with --trace.</translation>
+    </message>
+    <message>
+        <source>dumpModelStatsFunctionDescription</source>
+        <translation>Write the signal counters and the filter/sort times of the list models into the file, or into the logs without file. The application must have been started with --model-stats.</translation>
+    </message>
+    <message>
+        <source>exportCallStatsFunctionDescription</source>
+        <translation>Export a call stats recording (the last one by default) to CSV or JSON (format=csv|json) next to the recording file.</translation>
+    </message>
 </context>
 <context>
     <name>CodecsViewer</name>
@@ -1827,6 +1851,13 @@ Click here: &lt;a href=&quot;%1&quot;&gt;%1&lt;/a&gt;
         <source>newFileMessage</source>
         <translation>New attachment received!</translation>
     </message>
+    <message numerus="yes">
+        <source>newMessagesSummary</source>
+        <translation>
+            <numerusform>%n new message in %1</numerusform>
+            <numerusform>%n new messages in %1</numerusform>
+        </translation>
+    </message>
 </context>
 <context>
     <name>OnlineInstallerDialog</name>
@@ -117,6 +117,18 @@
         <source>checkForUpdates</source>
         <translation>Vérifier les mises à jour</translation>
     </message>
+    <message>
+        <source>commandLineOptionTrace</source>
+        <translation>enregistre les étapes du démarrage et les écrit en tant que trace Chrome dans le dossier des journaux</translation>
+    </message>
+    <message>
+        <source>commandLineOptionModelStats</source>
+        <translation>compte les signaux et le temps de filtrage/tri des modèles de listes et les écrit dans les journaux toutes les &lt;secondes&gt; (0 : seulement avec la commande dump-model-stats)</translation>
+    </message>
+    <message>
+        <source>commandLineOptionModelStatsArg</source>
+        <translation>secondes</translation>
+    </message>
 </context>
 <context>
     <name>AssistantAbstractView</name>
@@ -689,6 +701,18 @@ URL du serveur non configurée.</translation>
         <source>byeFunctionDescription</source>
         <translation>Terminer un appel spécifique, tous les appels ou l&apos;appel en cours.</translation>
     </message>
+    <message>
+        <source>dumpTraceFunctionDescription</source>
+        <translation>Écrit les étapes enregistrées depuis le démarrage au format de trace Chrome. L&apos;application doit avoir été lancée avec --trace.</translation>
+    </message>
+    <message>
+        <source>dumpModelStatsFunctionDescription</source>
+        <translation>Écrit les compteurs de signaux et les temps de filtrage/tri des modèles de listes dans le fichier, ou dans les journaux sans fichier. L&apos;application doit avoir été lancée avec --model-stats.</translation>
+    </message>
+    <message>
+        <source>exportCallStatsFunctionDescription</source>
+        <translation>Exporte un enregistrement des statistiques d&apos;appel (le dernier par défaut) en CSV ou JSON (format=csv|json) à côté du fichier enregistré.</translation>
+    </message>
 </context>
 <context>
     <name>CodecsViewer</name>
@@ -1827,6 +1851,13 @@ Cliquez ici : &lt;a href=&quot;%1&quot;&gt;%1&lt;/a&gt;
         <source>newFileMessage</source>
         <translation>Pièce jointe reçue !</translation>
     </message>
+    <message numerus="yes">
+        <source>newMessagesSummary</source>
+        <translation>
+            <numerusform>%n nouveau message dans %1</numerusform>
+            <numerusform>%n nouveaux messages dans %1</numerusform>
+        </translation>
+    </message>
 </context>
 <context>
     <name>OnlineInstallerDialog</name>
@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) 2022 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <cstdlib>
+#include <cstring>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+#include <QThread>
+#include <QVector>
+
+#include <bctoolbox/list.h>
+#include <bctoolbox/port.h>
+#include <mediastreamer2/msfactory.h>
+
+#include "utils/MediastreamerUtils.hpp"
+
+#if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
+namespace Qt {
+	using ::endl;
+	constexpr QString::SplitBehavior SkipEmptyParts = QString::SkipEmptyParts;
+}
+#endif
+
+// =============================================================================
+// Headless benchmark of the audio settings graph (`SimpleCaptureGraph`).
+// The sound cards are replaced by the cards of a `Benchmark` driver : the
+// capture card emits a pulse every `PulsePeriod` ms and the playback card
+// detects it. For each capture/playback sample rates, the graph latency, the
+// lost pulses, the resampler cost and the late ticks are reported.
+// =============================================================================
+
+namespace {
+	constexpr char DriverType[] = "Benchmark";
+	constexpr char ResamplerName[] = "MSResample";
+	
+	constexpr int PulsePeriod = 200;// In ms.
+	constexpr int PulseLength = 5;// In ms.
+	constexpr int16_t PulseAmplitude = 16000;
+	
+	// Results of the current run. Written from the ticker thread while the graph is running.
+	struct Run {
+		int emittedPulses = 0;
+		QVector<double> latencies;// In ms.
+		int ticks = 0;
+		int lateTicks = 0;
+	};
+	
+	struct PulseState {
+		int rate = 0;
+		uint64_t position = 0;// In samples.
+		bool inPulse = false;
+		uint64_t startTime = 0;
+		uint64_t startTickerTime = 0;
+	};
+	
+	MSFactory *Factory = nullptr;
+	QVector<int> Rates;
+	Run CurrentRun;
+	
+	// -------------------------------------------------------------------------
+	// Filters of the benchmark cards.
+	// -------------------------------------------------------------------------
+	
+	void pulseInit (MSFilter *f) {
+		f->data = new PulseState();
+	}
+	
+	void pulseUninit (MSFilter *f) {
+		delete static_cast<PulseState *>(f->data);
+	}
+	
+	int pulseGetSampleRate (MSFilter *f, void *arg) {
+		*static_cast<int *>(arg) = static_cast<PulseState *>(f->data)->rate;
+		return 0;
+	}
+	
+	int pulseGetNChannels (MSFilter *, void *arg) {
+		*static_cast<int *>(arg) = 1;
+		return 0;
+	}
+	
+	void pulseGeneratorProcess (MSFilter *f) {
+		PulseState *state = static_cast<PulseState *>(f->data);
+		const int count = int(state->rate * f->ticker->interval / 1000);
+		const uint64_t period = uint64_t(state->rate) * PulsePeriod / 1000;
+		const uint64_t length = uint64_t(state->rate) * PulseLength / 1000;
+		
+		mblk_t *m = allocb(size_t(count) * sizeof(int16_t), 0);
+		int16_t *samples = reinterpret_cast<int16_t *>(m->b_wptr);
+		for (int i = 0; i < count; ++i, ++state->position) {
+			const uint64_t offset = state->position % period;
+			if (offset == 0)
+				++CurrentRun.emittedPulses;
+			samples[i] = offset < length ? PulseAmplitude : 0;
+		}
+		m->b_wptr += size_t(count) * sizeof(int16_t);
+		ms_queue_put(f->outputs[0], m);
+	}
+	
+	void pulseDetectorProcess (MSFilter *f) {
+		PulseState *state = static_cast<PulseState *>(f->data);
+		
+		// A tick is late when the ticker runs behind the wall clock by more than one interval.
+		const uint64_t now = bctbx_get_cur_time_ms();
+		if (CurrentRun.ticks++ == 0) {
+			state->startTime = now;
+			state->startTickerTime = f->ticker->time;
+		} else if (int64_t(now - state->startTime) - int64_t(f->ticker->time - state->startTickerTime) > f->ticker->interval)
+			++CurrentRun.lateTicks;
+		
+		mblk_t *m;
+		while ((m = ms_queue_get(f->inputs[0]))) {
+			for (const int16_t *sample = reinterpret_cast<const int16_t *>(m->b_rptr); sample < reinterpret_cast<const int16_t *>(m->b_wptr); ++sample, ++state->position) {
+				const int level = std::abs(int(*sample));
+				if (!state->inPulse && level > PulseAmplitude / 2) {
+					state->inPulse = true;
+					const double time = state->position * 1000.0 / state->rate;
+					CurrentRun.latencies << time - CurrentRun.latencies.size() * PulsePeriod;
+				} else if (state->inPulse && level < PulseAmplitude / 4)
+					state->inPulse = false;
+			}
+			freemsg(m);
+		}
+	}
+	
+	MSFilterMethod PulseMethods[] = {
+		{ MS_FILTER_GET_SAMPLE_RATE, pulseGetSampleRate },
+		{ MS_FILTER_GET_NCHANNELS, pulseGetNChannels },
+		{ 0, nullptr }
+	};
+	
+	MSFilterDesc createPulseFilterDesc (const char *name, int ninputs, int noutputs, MSFilterFunc process) {
+		MSFilterDesc desc = {};
+		desc.id = MS_FILTER_PLUGIN_ID;
+		desc.name = name;
+		desc.text = "Pulse generator or detector of the audio benchmark.";
+		desc.category = MS_FILTER_OTHER;
+		desc.ninputs = ninputs;
+		desc.noutputs = noutputs;
+		desc.init = pulseInit;
+		desc.process = process;
+		desc.uninit = pulseUninit;
+		desc.methods = PulseMethods;
+		return desc;
+	}
+	
+	MSFilterDesc PulseGeneratorDesc = createPulseFilterDesc("BenchmarkPulseGenerator", 0, 1, pulseGeneratorProcess);
+	MSFilterDesc PulseDetectorDesc = createPulseFilterDesc("BenchmarkPulseDetector", 1, 0, pulseDetectorProcess);
+	
+	// -------------------------------------------------------------------------
+	// Benchmark cards. One card by sample rate, named `Benchmark: <rate> Hz`.
+	// -------------------------------------------------------------------------
+	
+	int getCardRate (MSSndCard *card) {
+		return int(reinterpret_cast<intptr_t>(card->data));
+	}
+	
+	MSFilter *createCardFilter (MSSndCard *card, MSFilterDesc *desc) {
+		MSFilter *f = ms_factory_create_filter_from_desc(Factory, desc);
+		static_cast<PulseState *>(f->data)->rate = getCardRate(card);
+		return f;
+	}
+	
+	MSFilter *benchmarkCardCreateReader (MSSndCard *card) {
+		return createCardFilter(card, &PulseGeneratorDesc);
+	}
+	
+	MSFilter *benchmarkCardCreateWriter (MSSndCard *card) {
+		return createCardFilter(card, &PulseDetectorDesc);
+	}
+	
+	void benchmarkCardDetect (MSSndCardManager *manager);
+	
+	MSSndCardDesc createCardDesc () {
+		MSSndCardDesc desc = {};
+		desc.driver_type = DriverType;
+		desc.detect = benchmarkCardDetect;
+		desc.create_reader = benchmarkCardCreateReader;
+		desc.create_writer = benchmarkCardCreateWriter;
+		return desc;
+	}
+	
+	MSSndCardDesc BenchmarkCardDesc = createCardDesc();
+	
+	void benchmarkCardDetect (MSSndCardManager *manager) {
+		for (int rate : Rates) {
+			MSSndCard *card = ms_snd_card_new(&BenchmarkCardDesc);
+			card->name = ms_strdup_printf("%d Hz", rate);
+			card->capabilities = MS_SND_CARD_CAP_CAPTURE | MS_SND_CARD_CAP_PLAYBACK;
+			card->data = reinterpret_cast<void *>(intptr_t(rate));
+			ms_snd_card_manager_add_card(manager, card);
+		}
+	}
+	
+	std::string getCardId (int rate) {
+		return std::string(DriverType) + ": " + std::to_string(rate) + " Hz";
+	}
+	
+	// -------------------------------------------------------------------------
+	
+	class BenchmarkGraph : public MediastreamerUtils::SimpleCaptureGraph {
+	public:
+		BenchmarkGraph (int captureRate, int playbackRate) : SimpleCaptureGraph(Factory, getCardId(captureRate), getCardId(playbackRate)) {
+			// The settings graph mutes its playback : the pulses must reach the detector.
+			float gain = 1.0f;
+			if (playbackVolumeFilter)
+				ms_filter_call_method(playbackVolumeFilter, static_cast<unsigned int>(MS_VOLUME_SET_GAIN), &gain);
+		}
+		
+		bool isValid () const {
+			return audioCapture && audioSink;
+		}
+		
+		float getTickerLoad () const {
+			return ticker ? ms_ticker_get_average_load(ticker) : 0.0f;
+		}
+	};
+	
+	// Average cost of one process call of a filter, in microseconds.
+	double getFilterCost (const char *name) {
+		for (const bctbx_list_t *it = ms_factory_get_statistics(Factory); it; it = bctbx_list_next(it)) {
+			const MSFilterStats *stats = static_cast<const MSFilterStats *>(bctbx_list_get_data(it));
+			if (!strcmp(stats->name, name) && stats->count > 0)
+				return stats->elapsed / 1000.0 / stats->count;
+		}
+		return 0.0;
+	}
+}
+
+// -----------------------------------------------------------------------------
+
+int main (int argc, char *argv[]) {
+	QCoreApplication app(argc, argv);
+	
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Headless latency and glitch benchmark of the audio settings graph.");
+	parser.addHelpOption();
+	QCommandLineOption durationOption("duration", "Duration of each run, in seconds.", "seconds", "2");
+	QCommandLineOption ratesOption("rates", "Comma separated sample rates of the cards.", "rates", "8000,16000,44100,48000");
+	QCommandLineOption maxLatencyOption("max-latency", "Fail if a latency is above this value, in ms.", "ms");
+	parser.addOption(durationOption);
+	parser.addOption(ratesOption);
+	parser.addOption(maxLatencyOption);
+	parser.process(app);
+	
+	const int duration = qMax(1, parser.value(durationOption).toInt());
+	const double maxLatency = parser.isSet(maxLatencyOption) ? parser.value(maxLatencyOption).toDouble() : -1.0;
+	for (const QString &rate : parser.value(ratesOption).split(',', Qt::SkipEmptyParts))
+		if (rate.toInt() > 0)
+			Rates << rate.toInt();
+	if (Rates.isEmpty())
+		parser.showHelp(EXIT_FAILURE);
+	
+	Factory = ms_factory_new_with_voip();
+	ms_factory_enable_statistics(Factory, TRUE);
+	ms_snd_card_manager_register_desc(ms_factory_get_snd_card_manager(Factory), &BenchmarkCardDesc);
+	
+	QTextStream out(stdout);
+	out << "capture (Hz)\tplayback (Hz)\tpulses\tlatency avg (ms)\tlatency max (ms)\tresampler (us/tick)\tticker load (%)\tlate ticks" << Qt::endl;
+	
+	bool success = true;
+	for (int captureRate : Rates)
+		for (int playbackRate : Rates) {
+			CurrentRun = Run();
+			ms_factory_reset_statistics(Factory);
+			
+			BenchmarkGraph graph(captureRate, playbackRate);
+			if (!graph.isValid()) {
+				out << captureRate << "\t" << playbackRate << "\tunable to create the graph" << Qt::endl;
+				success = false;
+				continue;
+			}
+			graph.start();
+			QThread::msleep(ulong(duration) * 1000);
+			const float load = graph.getTickerLoad();
+			graph.stop();
+			
+			double average = 0.0, maximum = 0.0;
+			for (double latency : CurrentRun.latencies) {
+				average += latency;
+				maximum = qMax(maximum, latency);
+			}
+			if (!CurrentRun.latencies.isEmpty())
+				average /= CurrentRun.latencies.size();
+			// The last pulse may still be in the graph.
+			const int lostPulses = CurrentRun.emittedPulses - CurrentRun.latencies.size() - 1;
+			if (CurrentRun.latencies.isEmpty() || lostPulses > 0 || (maxLatency >= 0 && maximum > maxLatency))
+				success = false;
+			
+			out << captureRate << "\t" << playbackRate << "\t"
+				<< CurrentRun.latencies.size() << "/" << CurrentRun.emittedPulses << "\t"
+				<< QString::number(average, 'f', 2) << "\t" << QString::number(maximum, 'f', 2) << "\t"
+				<< QString::number(getFilterCost(ResamplerName), 'f', 2) << "\t"
+				<< QString::number(load, 'f', 1) << "\t"
+				<< CurrentRun.lateTicks << "/" << CurrentRun.ticks << Qt::endl;
+		}
+	
+	ms_factory_destroy(Factory);
+	return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
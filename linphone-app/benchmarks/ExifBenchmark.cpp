@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2022 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <QDateTime>
+#include <QFile>
+#include <QImage>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "utils/QExifImageHeader.hpp"
+
+// =============================================================================
+// Micro-benchmark of the orientation lookup done for each thumbnail: the full
+// EXIF parser (`loadFromJpeg` + `value`) against the header-only reader
+// (`readOrientation`). Run: `cmake --build . --target run-exif-benchmark`.
+// =============================================================================
+
+class ExifBenchmark : public QObject {
+	Q_OBJECT;
+
+private slots:
+	void initTestCase ();
+
+	void checkOrientations ();
+
+	void fullParser ();
+	void headerOnly ();
+	void headerOnlyInMemory ();
+
+private:
+	// A JPEG with the EXIF header of a camera: some tags and a thumbnail.
+	QString createJpeg (const QString &fileName, quint16 orientation);
+
+	QTemporaryDir mDir;
+	QString mFilePath;
+	QByteArray mData;
+};
+
+// -----------------------------------------------------------------------------
+
+QString ExifBenchmark::createJpeg (const QString &fileName, quint16 orientation) {
+	const QString filePath = mDir.filePath(fileName);
+	QImage image(1024, 768, QImage::Format_RGB32);
+	image.fill(Qt::darkCyan);
+	if (!image.save(filePath, "jpg"))
+		return QString();
+
+	QExifImageHeader header;
+	header.setValue(QExifImageHeader::Orientation, QExifValue(orientation));
+	header.setValue(QExifImageHeader::Make, QExifValue(QStringLiteral("Benchmark")));
+	header.setValue(QExifImageHeader::Model, QExifValue(QStringLiteral("Camera")));
+	header.setValue(QExifImageHeader::DateTime, QExifValue(QDateTime::currentDateTime()));
+	header.setValue(QExifImageHeader::XResolution, QExifValue(QExifURational(72, 1)));
+	header.setValue(QExifImageHeader::YResolution, QExifValue(QExifURational(72, 1)));
+	header.setValue(QExifImageHeader::ExifVersion, QExifValue(QByteArray("0231")));
+	header.setValue(QExifImageHeader::PixelXDimension, QExifValue(quint32(image.width())));
+	header.setValue(QExifImageHeader::PixelYDimension, QExifValue(quint32(image.height())));
+	header.setThumbnail(image.scaled(160, 120));
+	return header.saveToJpeg(filePath) ? filePath : QString();
+}
+
+void ExifBenchmark::initTestCase () {
+	QVERIFY(mDir.isValid());
+	mFilePath = createJpeg(QStringLiteral("image.jpg"), 6);
+	QVERIFY(!mFilePath.isEmpty());
+
+	QFile file(mFilePath);
+	QVERIFY(file.open(QIODevice::ReadOnly));
+	mData = file.readAll();
+}
+
+// Both readers must agree.
+void ExifBenchmark::checkOrientations () {
+	for (quint16 orientation = 1; orientation <= 8; ++orientation) {
+		const QString filePath = createJpeg(QStringLiteral("orientation-%1.jpg").arg(orientation), orientation);
+		QVERIFY(!filePath.isEmpty());
+
+		QExifImageHeader header;
+		QVERIFY(header.loadFromJpeg(filePath));
+		QCOMPARE(int(header.value(QExifImageHeader::Orientation).toShort()), int(orientation));
+
+		QSize dimensions;
+		QCOMPARE(QExifImageHeader::readOrientation(filePath, &dimensions), int(orientation));
+		QCOMPARE(dimensions, QSize(1024, 768));
+	}
+}
+
+// -----------------------------------------------------------------------------
+
+void ExifBenchmark::fullParser () {
+	int rotation = 0;
+	QBENCHMARK {
+		QExifImageHeader header;
+		if (header.loadFromJpeg(mFilePath))
+			rotation = int(header.value(QExifImageHeader::Orientation).toShort());
+	}
+	QCOMPARE(rotation, 6);
+}
+
+void ExifBenchmark::headerOnly () {
+	int rotation = 0;
+	QBENCHMARK {
+		rotation = QExifImageHeader::readOrientation(mFilePath);
+	}
+	QCOMPARE(rotation, 6);
+}
+
+// Parsing cost only, without file access.
+void ExifBenchmark::headerOnlyInMemory () {
+	const uchar *data = reinterpret_cast<const uchar *>(mData.constData());
+	int rotation = 0;
+	QBENCHMARK {
+		rotation = QExifImageHeader::readOrientation(data, mData.size());
+	}
+	QCOMPARE(rotation, 6);
+}
+
+QTEST_GUILESS_MAIN(ExifBenchmark)
+
+#include "ExifBenchmark.moc"
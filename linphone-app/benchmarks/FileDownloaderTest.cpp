@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2022 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QCryptographicHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSignalSpy>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "components/file/FileDownloader.hpp"
+
+// =============================================================================
+// Downloads against a local HTTP server: segments, checksum and resume with
+// ranges served, ignored (200) or refused with an error status. Run:
+// `cmake --build . --target run-file-downloader-test`.
+// =============================================================================
+
+namespace {
+constexpr char cFileName[] = "file.bin";
+constexpr char cETag[] = "\"file-v1\"";
+constexpr int cFileSize = 4 * 1024 * 1024;// Big enough to be split in segments of 1 MB.
+constexpr int cPartialSize = cFileSize / 2;
+constexpr int cSegments = 4;
+constexpr int cTimeout = 10000;
+}
+
+// One response by connection. Range requests are answered with `mRangeStatus`.
+class HttpServer : public QTcpServer {
+public:
+	HttpServer (const QByteArray &data) : mData(data) {
+		QObject::connect(this, &QTcpServer::newConnection, this, &HttpServer::handleNewConnection);
+	}
+
+	int mRangeStatus = 206;
+	int mHeadCount = 0;
+	QList<QByteArray> mRanges;// Range headers of the received GET requests.
+
+private:
+	void handleNewConnection () {
+		while (QTcpSocket *socket = nextPendingConnection()) {
+			QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+			QObject::connect(socket, &QTcpSocket::readyRead, this, [this, socket] {
+				QByteArray &request = mRequests[socket];
+				request += socket->readAll();
+				if (request.contains("\r\n\r\n"))
+					respond(socket, mRequests.take(socket));
+			});
+		}
+	}
+
+	void respond (QTcpSocket *socket, const QByteArray &request) {
+		const bool isHead = request.startsWith("HEAD ");
+		QByteArray range;
+		for (const QByteArray &line : request.split('\n'))
+			if (line.toLower().startsWith("range:"))
+				range = line.mid(int(qstrlen("range:"))).trimmed();
+		if (isHead)
+			++mHeadCount;
+		else
+			mRanges << range;
+
+		int status = 200;
+		QByteArray body = mData;
+		QByteArray headers = QByteArray("ETag: ") + cETag + "\r\nAccept-Ranges: bytes\r\n";
+		if (!range.isEmpty()) {
+			status = mRangeStatus;
+			if (status == 206) {
+				const QList<QByteArray> bounds = range.mid(int(qstrlen("bytes="))).split('-');
+				const int first = bounds.value(0).toInt();
+				const int last = bounds.value(1).isEmpty() ? mData.size() - 1 : qMin(bounds.value(1).toInt(), mData.size() - 1);
+				body = mData.mid(first, last - first + 1);
+				headers += "Content-Range: bytes " + QByteArray::number(first) + "-"
+					+ QByteArray::number(last) + "/" + QByteArray::number(mData.size()) + "\r\n";
+			} else if (status != 200)
+				body = "Error page";
+		}
+		socket->write("HTTP/1.1 " + QByteArray::number(status) + " Status\r\n" + headers
+			+ "Content-Length: " + QByteArray::number(body.size()) + "\r\nConnection: close\r\n\r\n"
+			+ (isHead ? QByteArray() : body));
+		socket->disconnectFromHost();
+	}
+
+	QByteArray mData;
+	QHash<QTcpSocket *, QByteArray> mRequests;
+};
+
+// -----------------------------------------------------------------------------
+
+class FileDownloaderTest : public QObject {
+	Q_OBJECT
+
+private slots:
+	void initTestCase ();
+	void init ();
+	void cleanup ();
+
+	void download ();
+	void downloadSegments ();
+	void failOnBadChecksum ();
+	void resume ();
+	void restartIfRangeIsIgnored ();
+	void restartIfRangeIsNotSatisfiable ();
+	void keepPartialFileOnTransientError_data ();
+	void keepPartialFileOnTransientError ();
+	void removePartialFileOnError ();
+
+private:
+	// Partial file and resume info as saved by an interrupted download.
+	void createPartialFile ();
+	// Return true if the download is finished, false if it failed.
+	bool runDownload (int segments = 1, const QString &checksum = QString());
+	QByteArray readFile (const QString &filePath) const;
+	QString getFilePath (const QString &suffix = QString()) const;
+
+	QByteArray mData;
+	QString mChecksum;
+	QScopedPointer<QTemporaryDir> mDir;
+	QScopedPointer<HttpServer> mServer;
+	QUrl mUrl;
+};
+
+// -----------------------------------------------------------------------------
+
+void FileDownloaderTest::initTestCase () {
+	mData.resize(cFileSize);
+	for (int i = 0; i < cFileSize; ++i)
+		mData[i] = char((i * 7 + i / 256) & 0xff);
+	mChecksum = "sha256:" + QString::fromLatin1(QCryptographicHash::hash(mData, QCryptographicHash::Sha256).toHex());
+}
+
+void FileDownloaderTest::init () {
+	mDir.reset(new QTemporaryDir());
+	QVERIFY(mDir->isValid());
+	mServer.reset(new HttpServer(mData));
+	QVERIFY(mServer->listen(QHostAddress::LocalHost));
+	mUrl = QUrl(QStringLiteral("http://127.0.0.1:%1/%2").arg(mServer->serverPort()).arg(cFileName));
+}
+
+void FileDownloaderTest::cleanup () {
+	mServer.reset();
+	mDir.reset();
+}
+
+void FileDownloaderTest::createPartialFile () {
+	QFile partialFile(getFilePath(".part"));
+	QVERIFY(partialFile.open(QIODevice::WriteOnly));
+	QCOMPARE(partialFile.write(mData.left(cPartialSize)), qint64(cPartialSize));
+	partialFile.close();
+
+	QFile infoFile(getFilePath(".part.info"));
+	QVERIFY(infoFile.open(QIODevice::WriteOnly));
+	infoFile.write(QJsonDocument(QJsonObject{
+		{ "url", mUrl.toString() },
+		{ "validator", QString::fromLatin1(cETag) },
+		{ "totalBytes", double(cFileSize) },
+		{ "segments", QJsonArray{ QJsonArray{ 0.0, double(cPartialSize), double(cFileSize - 1) } } }
+	}).toJson(QJsonDocument::Compact));
+}
+
+bool FileDownloaderTest::runDownload (int segments, const QString &checksum) {
+	FileDownloader downloader;
+	downloader.setUrl(mUrl);
+	downloader.setDownloadFolder(mDir->path());
+	downloader.setSegments(segments);
+	downloader.setChecksum(checksum.isEmpty() ? mChecksum : checksum);
+	QSignalSpy finished(&downloader, &FileDownloader::downloadFinished);
+	QSignalSpy failed(&downloader, &FileDownloader::downloadFailed);
+	downloader.download();
+	if (!QTest::qWaitFor([&] { return finished.count() + failed.count() > 0; }, cTimeout))
+		qWarning() << "Download timeout.";
+	return finished.count() == 1;
+}
+
+QByteArray FileDownloaderTest::readFile (const QString &filePath) const {
+	QFile file(filePath);
+	return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+QString FileDownloaderTest::getFilePath (const QString &suffix) const {
+	return mDir->filePath(cFileName) + suffix;
+}
+
+// -----------------------------------------------------------------------------
+
+void FileDownloaderTest::download () {
+	QVERIFY(runDownload());
+	QCOMPARE(readFile(getFilePath()), mData);
+	QCOMPARE(mServer->mRanges, QList<QByteArray>{ QByteArray() });
+}
+
+// One HEAD request, then one range request by segment written at its own position.
+void FileDownloaderTest::downloadSegments () {
+	QVERIFY(runDownload(cSegments));
+	QCOMPARE(mServer->mHeadCount, 1);
+	QCOMPARE(mServer->mRanges.size(), cSegments);
+	for (const QByteArray &range : mServer->mRanges)
+		QVERIFY(range.startsWith("bytes="));
+	QCOMPARE(readFile(getFilePath()), mData);
+	QVERIFY(!QFile::exists(getFilePath(".part")));
+}
+
+void FileDownloaderTest::failOnBadChecksum () {
+	const QString badChecksum = "sha256:" + QString::fromLatin1(QCryptographicHash::hash("other", QCryptographicHash::Sha256).toHex());
+	QVERIFY(!runDownload(1, badChecksum));
+	QVERIFY(!QFile::exists(getFilePath()));
+	QVERIFY(!QFile::exists(getFilePath(".part")));
+	QVERIFY(!QFile::exists(getFilePath(".part.info")));
+}
+
+void FileDownloaderTest::resume () {
+	createPartialFile();
+	QVERIFY(runDownload());
+	QCOMPARE(mServer->mRanges, QList<QByteArray>{ "bytes=" + QByteArray::number(cPartialSize) + "-" + QByteArray::number(cFileSize - 1) });
+	QCOMPARE(readFile(getFilePath()), mData);
+	QVERIFY(!QFile::exists(getFilePath(".part.info")));
+}
+
+// 200 to a range request: the server sends the full file.
+void FileDownloaderTest::restartIfRangeIsIgnored () {
+	mServer->mRangeStatus = 200;
+	createPartialFile();
+	QVERIFY(runDownload());
+	QCOMPARE(readFile(getFilePath()), mData);
+}
+
+// 416: the partial file is dropped and the file is downloaded again from the first byte.
+void FileDownloaderTest::restartIfRangeIsNotSatisfiable () {
+	mServer->mRangeStatus = 416;
+	createPartialFile();
+	QVERIFY(runDownload());
+	QCOMPARE(mServer->mRanges.size(), 2);
+	QVERIFY(!mServer->mRanges.first().isEmpty());
+	QVERIFY(mServer->mRanges.last().isEmpty());
+	QCOMPARE(readFile(getFilePath()), mData);
+}
+
+void FileDownloaderTest::keepPartialFileOnTransientError_data () {
+	QTest::addColumn<int>("status");
+	QTest::newRow("request timeout") << 408;
+	QTest::newRow("too many requests") << 429;
+	QTest::newRow("internal server error") << 500;
+	QTest::newRow("service unavailable") << 503;
+}
+
+// A transient error must not throw away the downloaded data.
+void FileDownloaderTest::keepPartialFileOnTransientError () {
+	QFETCH(int, status);
+	mServer->mRangeStatus = status;
+	createPartialFile();
+	QVERIFY(!runDownload());
+	QVERIFY(!QFile::exists(getFilePath()));
+	QCOMPARE(readFile(getFilePath(".part")), mData.left(cPartialSize));
+	QVERIFY(QFile::exists(getFilePath(".part.info")));
+
+	// And the download can be resumed once the server is back.
+	mServer->mRangeStatus = 206;
+	QVERIFY(runDownload());
+	QCOMPARE(readFile(getFilePath()), mData);
+}
+
+void FileDownloaderTest::removePartialFileOnError () {
+	mServer->mRangeStatus = 404;
+	createPartialFile();
+	QVERIFY(!runDownload());
+	QVERIFY(!QFile::exists(getFilePath()));
+	QVERIFY(!QFile::exists(getFilePath(".part")));
+	QVERIFY(!QFile::exists(getFilePath(".part.info")));
+}
+
+QTEST_GUILESS_MAIN(FileDownloaderTest)
+
+#include "FileDownloaderTest.moc"
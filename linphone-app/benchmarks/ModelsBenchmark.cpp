@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2022 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QElapsedTimer>
+#include <QQuickStyle>
+#include <QStandardPaths>
+#include <QTest>
+
+#include "app/App.hpp"
+#include "app/providers/ImageProvider.hpp"
+#include "components/chat-room/ChatRoomModel.hpp"
+#include "components/contact/VcardModel.hpp"
+#include "components/contacts/ContactsListModel.hpp"
+#include "components/contacts/ContactsListProxyModel.hpp"
+#include "components/core/CoreManager.hpp"
+#include "components/history/HistoryModel.hpp"
+#include "components/other/images/ImageListModel.hpp"
+#include "components/other/images/ImageModel.hpp"
+#include "components/sip-addresses/SipAddressesModel.hpp"
+#include "components/timeline/TimelineListModel.hpp"
+#include "utils/Utils.hpp"
+
+// =============================================================================
+// Headless benchmark of the models on a real application: the core is local
+// and offline (network unreachable) and filled with synthetic chat rooms, call
+// logs and contacts. Data are kept in the Qt test mode standard paths and only
+// completed on next runs.
+// Run: `cmake --build . --target run-models-benchmark`. It writes the results
+// in `models-benchmark.xml` (Qt Test XML). Any Qt Test output can be selected
+// with `-o <file>,<format>` (xml, csv, junitxml, tap, txt).
+// =============================================================================
+
+namespace {
+	constexpr int ChatRoomsCount = 50;
+	constexpr int MessagesCount = 500;// By chat room.
+	constexpr int CallLogsCount = 2000;
+	constexpr int ContactsCount = 1000;
+	constexpr int CoreStartTimeout = 30000;// In ms.
+	
+	constexpr char UsernamePrefix[] = "benchmark-";
+	constexpr char Domain[] = "benchmark.localhost";
+	
+	std::string getSipAddress (int index) {
+		return std::string("sip:") + UsernamePrefix + std::to_string(index) + "@" + Domain;
+	}
+	
+	bool isSynthetic (const std::shared_ptr<const linphone::Address> &address) {
+		return address && address->getDomain() == Domain;
+	}
+}
+
+class ModelsBenchmark : public QObject {
+	Q_OBJECT;
+	
+private slots:
+	void initTestCase ();
+	
+	void chatRoomModelInit ();
+	void chatRoomModelPaging ();
+	
+	void contactsListProxyModelFilter_data ();
+	void contactsListProxyModelFilter ();
+	
+	void timelineListModelUpdateTimelines ();
+	void timelineListModelUpdate ();
+	
+	void historyModelSetSipAddresses ();
+	void sipAddressesModelInitSipAddresses ();
+	
+	void imageProviderRequestImage_data ();
+	void imageProviderRequestImage ();
+	
+private:
+	// Return false if the data can't be created : benchmarks would run on wrong sizes.
+	bool createChatRooms ();
+	bool createCallLogs ();
+	bool createContacts ();
+	
+	std::shared_ptr<linphone::ChatRoom> mChatRoom;
+};
+
+// -----------------------------------------------------------------------------
+
+bool ModelsBenchmark::createChatRooms () {
+	auto core = CoreManager::getInstance()->getCore();
+	int count = 0;
+	for (const auto &chatRoom : core->getChatRooms())
+		if (isSynthetic(chatRoom->getPeerAddress()))
+			++count;
+	for (int i = count; i < ChatRoomsCount; ++i) {
+		auto params = core->createDefaultChatRoomParams();
+		params->setBackend(linphone::ChatRoomBackend::Basic);
+		std::list<std::shared_ptr<linphone::Address>> participants{ core->interpretUrl(getSipAddress(i)) };
+		auto chatRoom = core->createChatRoom(params, nullptr, participants);
+		if (!chatRoom) {
+			qWarning() << QStringLiteral("Unable to create chat room %1.").arg(i);
+			return false;
+		}
+		for (int j = 0; j < MessagesCount; ++j) {
+			auto message = chatRoom->createEmptyMessage();
+			message->addUtf8TextContent("Benchmark message " + std::to_string(j) + " of " + getSipAddress(i));
+			message->send();// Stored in the history, not delivered.
+		}
+	}
+	return true;
+}
+
+bool ModelsBenchmark::createCallLogs () {
+	auto core = CoreManager::getInstance()->getCore();
+	int count = 0;
+	for (const auto &callLog : core->getCallLogs())
+		if (isSynthetic(callLog->getRemoteAddress()))
+			++count;
+	auto localAddress = core->createPrimaryContactParsed();
+	const time_t now = time(nullptr);
+	for (int i = count; i < CallLogsCount; ++i) {
+		auto remoteAddress = core->interpretUrl(getSipAddress(i % ContactsCount));
+		const bool outgoing = (i % 2 == 0);
+		const auto status = (i % 3 == 0 ? linphone::Call::Status::Missed : linphone::Call::Status::Success);
+		const time_t startTime = now - (CallLogsCount - i) * 600;
+		auto callLog = core->createCallLog(
+			outgoing ? localAddress : remoteAddress,
+			outgoing ? remoteAddress : localAddress,
+			outgoing ? linphone::Call::Dir::Outgoing : linphone::Call::Dir::Incoming,
+			status == linphone::Call::Status::Success ? 60 : 0,
+			startTime,
+			status == linphone::Call::Status::Success ? startTime + 5 : 0,
+			status,
+			false,
+			5.0f
+		);
+		if (!callLog) {
+			qWarning() << QStringLiteral("Unable to create call log %1.").arg(i);
+			return false;
+		}
+	}
+	return true;
+}
+
+bool ModelsBenchmark::createContacts () {
+	CoreManager *coreManager = CoreManager::getInstance();
+	ContactsListModel *contacts = coreManager->getContactsListModel();
+	for (int i = contacts->rowCount(); i < ContactsCount; ++i) {
+		VcardModel *vcardModel = coreManager->createDetachedVcardModel();
+		vcardModel->setUsername(QStringLiteral("Benchmark Contact %1").arg(i));
+		vcardModel->addSipAddress(Utils::coreStringToAppString(getSipAddress(i)));
+		if (!contacts->addContact(vcardModel)) {
+			qWarning() << QStringLiteral("Unable to add contact %1.").arg(i);
+			return false;
+		}
+	}
+	return true;
+}
+
+void ModelsBenchmark::initTestCase () {
+	auto core = CoreManager::getInstance()->getCore();
+	core->setNetworkReachable(false);
+	
+	QVERIFY(createChatRooms());
+	QVERIFY(createCallLogs());
+	QVERIFY(createContacts());
+	QCoreApplication::processEvents();
+	
+	for (const auto &chatRoom : core->getChatRooms())
+		if (isSynthetic(chatRoom->getPeerAddress()) && chatRoom->getHistorySize() >= MessagesCount) {
+			mChatRoom = chatRoom;
+			break;
+		}
+	QVERIFY(mChatRoom);
+	qInfo() << QStringLiteral("Benchmark data: %1 chat rooms, %2 call logs, %3 contacts.")
+		.arg(core->getChatRooms().size())
+		.arg(core->getCallLogs().size())
+		.arg(CoreManager::getInstance()->getContactsListModel()->rowCount());
+}
+
+// -----------------------------------------------------------------------------
+
+// First page of entries, as done when a chat room is opened.
+void ModelsBenchmark::chatRoomModelInit () {
+	int count = 0;
+	QBENCHMARK {
+		auto model = ChatRoomModel::create(mChatRoom);
+		model->initEntries();
+		count = model->rowCount();
+	}
+	QVERIFY(count > 0);
+}
+
+// All pages of entries, as done by scrolling to the top of the chat room.
+void ModelsBenchmark::chatRoomModelPaging () {
+	int count = 0;
+	QBENCHMARK {
+		auto model = ChatRoomModel::create(mChatRoom);
+		model->initEntries();
+		while (model->loadMoreEntries() > 1);
+		count = model->rowCount();
+	}
+	QVERIFY(count >= MessagesCount);
+}
+
+// -----------------------------------------------------------------------------
+
+void ModelsBenchmark::contactsListProxyModelFilter_data () {
+	QTest::addColumn<QString>("pattern");
+	
+	QTest::newRow("letter") << QStringLiteral("b");
+	QTest::newRow("name") << QStringLiteral("Contact 42");
+	QTest::newRow("address") << QStringLiteral("benchmark-42@");
+	QTest::newRow("no match") << QStringLiteral("no contact matches this");
+}
+
+// A filter pass with the pattern, then a pass without filter.
+void ModelsBenchmark::contactsListProxyModelFilter () {
+	QFETCH(QString, pattern);
+	ContactsListProxyModel proxy;
+	QBENCHMARK {
+		proxy.setFilter(pattern);
+		proxy.setFilter(QString());
+	}
+	QVERIFY(proxy.rowCount() >= ContactsCount);
+}
+
+// -----------------------------------------------------------------------------
+
+// Creation of all the timelines (updateTimelines from an empty list).
+void ModelsBenchmark::timelineListModelUpdateTimelines () {
+	int count = 0;
+	QBENCHMARK {
+		TimelineListModel timelines;
+		count = timelines.rowCount();
+	}
+	QVERIFY(count >= ChatRoomsCount);
+}
+
+// updateTimelines on an up-to-date list, as done on each received message.
+void ModelsBenchmark::timelineListModelUpdate () {
+	TimelineListModel *timelines = CoreManager::getInstance()->getTimelineListModel();
+	QBENCHMARK {
+		timelines->update();
+	}
+	QVERIFY(timelines->rowCount() >= ChatRoomsCount);
+}
+
+// -----------------------------------------------------------------------------
+
+// The constructors fill the models from the call logs (HistoryModel::setSipAddresses),
+// and from chat rooms, call logs and contacts (SipAddressesModel::initSipAddresses).
+void ModelsBenchmark::historyModelSetSipAddresses () {
+	int count = 0;
+	QBENCHMARK {
+		HistoryModel history;
+		count = history.rowCount();
+	}
+	QVERIFY(count >= CallLogsCount);
+}
+
+void ModelsBenchmark::sipAddressesModelInitSipAddresses () {
+	int count = 0;
+	QBENCHMARK {
+		SipAddressesModel sipAddresses;
+		count = sipAddresses.rowCount();
+	}
+	QVERIFY(count >= ContactsCount);
+}
+
+// -----------------------------------------------------------------------------
+
+void ModelsBenchmark::imageProviderRequestImage_data () {
+	QTest::addColumn<QString>("id");
+	QTest::addColumn<QSize>("requestedSize");
+	
+	ImageListModel *images = App::getInstance()->getImageListModel();
+	QVERIFY(images && images->rowCount() > 0);
+	for (int i = 0; i < qMin(3, images->rowCount()); ++i) {
+		const QString id = images->getAt<ImageModel>(i)->getId();
+		QTest::newRow(qPrintable(id + " 32x32")) << id << QSize(32, 32);
+		QTest::newRow(qPrintable(id + " 256x256")) << id << QSize(256, 256);
+	}
+}
+
+void ModelsBenchmark::imageProviderRequestImage () {
+	QFETCH(QString, id);
+	QFETCH(QSize, requestedSize);
+	ImageProvider provider;
+	QImage image;
+	QBENCHMARK {
+		QSize size;
+		image = provider.requestImage(id, &size, requestedSize);
+	}
+	QVERIFY(!image.isNull());
+}
+
+// -----------------------------------------------------------------------------
+
+int main (int argc, char *argv[]) {
+	if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+	qputenv("QML_DISABLE_DISK_CACHE", "true");
+	// Own name and test paths : the single application key, the configuration and the databases are not the ones of the user.
+	QCoreApplication::setApplicationName("linphone-app-benchmarks");
+	QStandardPaths::setTestModeEnabled(true);
+	
+	// Qt Test options are not options of the application.
+	int appArgc = 1;
+	char *appArgv[] = { argv[0], nullptr };
+	App app(appArgc, appArgv);
+	if (app.isSecondary()) {
+		qWarning() << QStringLiteral("Another benchmark is running.");
+		return EXIT_FAILURE;
+	}
+	QQuickStyle::setStyle("Default");
+	app.initContentApp();
+	
+	QElapsedTimer timer;
+	timer.start();
+	while (!CoreManager::getInstance()->started() && timer.elapsed() < CoreStartTimeout)
+		app.processEvents(QEventLoop::AllEvents, 100);
+	if (!CoreManager::getInstance()->started()) {
+		qWarning() << QStringLiteral("The core has not been started in %1 ms.").arg(CoreStartTimeout);
+		return EXIT_FAILURE;
+	}
+	
+	int result;
+	{
+		ModelsBenchmark benchmark;
+		result = QTest::qExec(&benchmark, argc, argv);
+	}
+	app.stop();
+	return result;
+}
+
+#include "ModelsBenchmark.moc"
@@ -43,6 +43,8 @@
 #include "providers/ImageProvider.hpp"
 #include "providers/ExternalImageProvider.hpp"
 #include "providers/ThumbnailProvider.hpp"
+#include "tracer/ModelStats.hpp"
+#include "tracer/Tracer.hpp"
 #include "translator/DefaultTranslator.hpp"
 #include "utils/Utils.hpp"
 #include "utils/Constants.hpp"
@@ -199,6 +201,9 @@ App::App (int &argc, char *argv[]) : SingleApplication(argc, argv, true, Mode::U
 	
 	createParser();
 	mParser->process(*this);
+	Tracer::init(mParser->isSet("trace"));
+	ModelStats::init(mParser->isSet("model-stats"), mParser->value("model-stats").toInt());
+	Tracer::Span span("App::App");
 	
 	// Initialize logger.
 	shared_ptr<linphone::Config> config = Utils::getConfigIfExists (QString::fromStdString(getConfigPathIfExists(*mParser)));
@@ -276,6 +281,7 @@ void App::processArguments(QHash<QString,QString> args){
 }
 
 static QQuickWindow *createSubWindow (QQmlApplicationEngine *engine, const char *path) {
+	Tracer::Span span(path);
 	qInfo() << QStringLiteral("Creating subwindow: `%1`.").arg(path);
 	
 	QQmlComponent component(engine, QUrl(path));
@@ -297,6 +303,7 @@ static QQuickWindow *createSubWindow (QQmlApplicationEngine *engine, const char
 // -----------------------------------------------------------------------------
 
 void App::initContentApp () {
+	Tracer::Span span("App::initContentApp");
 	std::string configPath;
 	shared_ptr<linphone::Config> config;
 	bool mustBeIconified = false;
@@ -312,6 +319,8 @@ void App::initContentApp () {
 		delete mEngine;
 		
 		mNotifier = nullptr;
+		mCallsWindow = nullptr;
+		mSettingsWindow = nullptr;
 		//
 		CoreManager::uninit();
 		removeTranslator(mTranslator);
@@ -355,11 +364,16 @@ void App::initContentApp () {
 	config->setString("storage", "call_logs_db_uri", Paths::getCallHistoryFilePath());
 	
 	// Init core.
-	CoreManager::init(this, Utils::coreStringToAppString(configPath));
-	
+	{
+		Tracer::Span span("CoreManager::init");
+		CoreManager::init(this, Utils::coreStringToAppString(configPath));
+	}
 	
 	// Init engine content.
-	mEngine = new QQmlApplicationEngine(this);
+	{
+		Tracer::Span span("QQmlApplicationEngine::QQmlApplicationEngine");
+		mEngine = new QQmlApplicationEngine(this);
+	}
 	
 	// Provide `+custom` folders for custom components and `5.9` for old components.
 	{
@@ -404,16 +418,25 @@ void App::initContentApp () {
 	mEngine->rootContext()->setContextProperty("Colors", mColorListModel->getQmlData());
 	mEngine->rootContext()->setContextProperty("Images", mImageListModel->getQmlData());
 	
-	registerTypes();
-	registerSharedTypes();
-	registerToolTypes();
-	registerSharedToolTypes();
+	{
+		Tracer::Span span("App::registerTypes");
+		registerTypes();
+		registerSharedTypes();
+		registerToolTypes();
+		registerSharedToolTypes();
+	}
 	
 	// Enable notifications.
-	mNotifier = new Notifier(mEngine);
+	{
+		Tracer::Span span("Notifier::Notifier");
+		mNotifier = new Notifier(mEngine);
+	}
 	// Load main view.
 	qInfo() << QStringLiteral("Loading main view...");
-	mEngine->load(QUrl(Constants::QmlViewMainWindow));
+	{
+		Tracer::Span span("App::loadMainWindow");
+		mEngine->load(QUrl(Constants::QmlViewMainWindow));
+	}
 	if (mEngine->rootObjects().isEmpty())
 		qFatal("Unable to open main window.");
 	
@@ -465,12 +488,16 @@ bool App::event (QEvent *event) {
 
 // -----------------------------------------------------------------------------
 
-QQuickWindow *App::getCallsWindow () const {
+QQuickWindow *App::getCallsWindow () {
 	if (CoreManager::getInstance()->getCore()->getConfig()->getInt(
 				SettingsModel::UiSection, "disable_calls_window", 0
 				))
 		return nullptr;
 	
+	if (!mCallsWindow) {
+		mCallsWindow = createSubWindow(mEngine, Constants::QmlViewCallsWindow);
+		releaseSubWindowWhenUnused(mCallsWindow, &App::mCallsWindow);
+	}
 	return mCallsWindow;
 }
 
@@ -480,10 +507,53 @@ QQuickWindow *App::getMainWindow () const {
 				);
 }
 
-QQuickWindow *App::getSettingsWindow () const {
+QQuickWindow *App::getSettingsWindow () {
+	if (!mSettingsWindow) {
+		mSettingsWindow = createSubWindow(mEngine, Constants::QmlViewSettingsWindow);
+		QObject::connect(mSettingsWindow, &QWindow::visibilityChanged, this, [](QWindow::Visibility visibility) {
+			if (visibility == QWindow::Hidden) {
+				qInfo() << QStringLiteral("Update nat policy.");
+				shared_ptr<linphone::Core> core = CoreManager::getInstance()->getCore();
+				core->setNatPolicy(core->getNatPolicy());
+			}
+		});
+		releaseSubWindowWhenUnused(mSettingsWindow, &App::mSettingsWindow);
+	}
 	return mSettingsWindow;
 }
 
+// Destroy a sub-window that stayed hidden for `subwindows_release_delay` ms. It will be created again on next use.
+void App::releaseSubWindowWhenUnused (QQuickWindow *window, QQuickWindow *App::*windowMember) {
+	const int delay = CoreManager::getInstance()->getCore()->getConfig()->getInt(
+				SettingsModel::UiSection, "subwindows_release_delay", 0
+				);
+	if (delay <= 0)
+		return;
+	
+	QTimer *timer = new QTimer(window);
+	timer->setSingleShot(true);
+	timer->setInterval(delay);
+	QObject::connect(window, &QWindow::visibleChanged, timer, [timer](bool visible) {
+		if (visible)
+			timer->stop();
+		else
+			timer->start();
+	});
+	QObject::connect(timer, &QTimer::timeout, this, [this, window, windowMember, timer] {
+		if (window->isVisible())
+			return;
+		if (windowMember == &App::mCallsWindow && CoreManager::getInstance()->getCore()->getCallsNb() > 0) {
+			timer->start();// Calls are still running: keep it.
+			return;
+		}
+		qInfo() << QStringLiteral("Releasing unused subwindow: `%1`.").arg(window->title());
+		this->*windowMember = nullptr;
+		window->deleteLater();
+	});
+	if (!window->isVisible())
+		timer->start();
+}
+
 // -----------------------------------------------------------------------------
 
 void App::smartShowWindow (QQuickWindow *window) {
@@ -527,7 +597,9 @@ void App::createParser () {
 						#ifndef Q_OS_MACOS
 							{ "iconified", tr("commandLineOptionIconified") },
 						#endif // ifndef Q_OS_MACOS
-							{ { "V", "verbose" }, tr("commandLineOptionVerbose") }
+							{ { "V", "verbose" }, tr("commandLineOptionVerbose") },
+							{ "trace", tr("commandLineOptionTrace") },
+							{ "model-stats", tr("commandLineOptionModelStats"), tr("commandLineOptionModelStatsArg") }
 						});
 }
 
@@ -965,19 +1037,19 @@ void App::setAutoStart (bool enabled) {
 // -----------------------------------------------------------------------------
 
 void App::openAppAfterInit (bool mustBeIconified) {
+	Tracer::Span span("App::openAppAfterInit");
 	qInfo() << QStringLiteral("Open " APPLICATION_NAME " app.");
 	auto coreManager = CoreManager::getInstance();
 	coreManager->getSettingsModel()->updateCameraMode();
-	// Create other windows.
-	mCallsWindow = createSubWindow(mEngine, Constants::QmlViewCallsWindow);
-	mSettingsWindow = createSubWindow(mEngine, Constants::QmlViewSettingsWindow);
-	QObject::connect(mSettingsWindow, &QWindow::visibilityChanged, this, [coreManager](QWindow::Visibility visibility) {
-		if (visibility == QWindow::Hidden) {
-			qInfo() << QStringLiteral("Update nat policy.");
-			shared_ptr<linphone::Core> core = coreManager->getCore();
-			core->setNatPolicy(core->getNatPolicy());
-		}
-	});
+	// Other windows are created on first use. They can be created ahead when the application is idle.
+	const int prewarmDelay = coreManager->getCore()->getConfig()->getInt(
+				SettingsModel::UiSection, "subwindows_prewarm_delay", -1
+				);
+	if (prewarmDelay >= 0)
+		QTimer::singleShot(prewarmDelay, mEngine, [this] {
+			getCallsWindow();
+			getSettingsWindow();
+		});
 	
 	QQuickWindow *mainWindow = getMainWindow();
 	
@@ -1033,6 +1105,10 @@ void App::openAppAfterInit (bool mustBeIconified) {
 #endif
 		setOpened(true);
 	}
+	if (Tracer::isEnabled())// Let the main window be shown before writing startup spans.
+		QTimer::singleShot(0, this, [] {
+			Tracer::dump(Tracer::getDefaultFilePath());
+		});
 }
 
 // -----------------------------------------------------------------------------
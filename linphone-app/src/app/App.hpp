@@ -110,8 +110,14 @@ public:
     exit(RestartCode);
   }
 
-  Q_INVOKABLE QQuickWindow *getCallsWindow () const;
-  Q_INVOKABLE QQuickWindow *getSettingsWindow () const;
+  // Sub-windows are created on first use.
+  Q_INVOKABLE QQuickWindow *getCallsWindow ();
+  Q_INVOKABLE QQuickWindow *getSettingsWindow ();
+
+  // Do not create the window if it doesn't exist yet.
+  QQuickWindow *getCallsWindowIfCreated () const {
+    return mCallsWindow;
+  }
 
   Q_INVOKABLE static void smartShowWindow (QQuickWindow *window);
   Q_INVOKABLE static void checkForUpdates(bool force = false);
@@ -155,6 +161,7 @@ private:
   void setAutoStart (bool enabled);
 
   void openAppAfterInit (bool mustBeIconified = false);
+  void releaseSubWindowWhenUnused (QQuickWindow *window, QQuickWindow *App::*windowMember);
 
   void setOpened (bool status) {
     if (mIsOpened != status) {
@@ -25,6 +25,9 @@
 #include "config.h"
 
 #include "app/App.hpp"
+#include "app/tracer/ModelStats.hpp"
+#include "app/tracer/Tracer.hpp"
+#include "components/call/CallStatsRecorder.hpp"
 #include "components/calls/CallsListModel.hpp"
 #include "components/core/CoreHandlers.hpp"
 #include "components/core/CoreManager.hpp"
@@ -194,6 +197,29 @@ static void cliInitiateConference (QHash<QString, QString> &args) {
 	updateCallsWindow();
 }
 
+static void cliDumpTrace (QHash<QString, QString> &args) {
+	const QString filePath = args.value("file");
+	Tracer::dump(filePath.isEmpty() ? Tracer::getDefaultFilePath() : filePath);
+}
+
+static void cliDumpModelStats (QHash<QString, QString> &args) {
+	ModelStats::dump(args.value("file"));
+}
+
+static void cliExportCallStats (QHash<QString, QString> &args) {
+	const QString filePath = CallStatsRecorder::findRecording(args.value("file"));
+	if (filePath.isEmpty()) {
+		qWarning() << QStringLiteral("No call stats recording found in: `%1`.").arg(CallStatsRecorder::getDirPath());
+		return;
+	}
+	const QString format = args.value("format");
+	if (!format.isEmpty() && format != "csv" && format != "json") {
+		qWarning() << QStringLiteral("Unknown export format: `%1`.").arg(format);
+		return;
+	}
+	CallStatsRecorder::exportRecording(filePath, format == "json" ? CallStatsRecorder::JsonFormat : CallStatsRecorder::CsvFormat);
+}
+
 // =============================================================================
 // Helpers.
 // =============================================================================
@@ -428,6 +454,15 @@ QMap<QString, Cli::Command> Cli::mCommands = {
 		{ "sip-address", {} }, { "conference-id", {} }, { "guest-sip-address", {} }
 	}),
 	createCommand("bye", QT_TR_NOOP("byeFunctionDescription"), cliBye, QHash<QString, Argument>(), true),
+	createCommand("dump-trace", QT_TR_NOOP("dumpTraceFunctionDescription"), cliDumpTrace, {
+		{ "file", { String, true } }
+	}),
+	createCommand("dump-model-stats", QT_TR_NOOP("dumpModelStatsFunctionDescription"), cliDumpModelStats, {
+		{ "file", { String, true } }
+	}),
+	createCommand("export-call-stats", QT_TR_NOOP("exportCallStatsFunctionDescription"), cliExportCallStats, {
+		{ "file", { String, true } }, { "format", { String, true } }
+	}),
 };
 
 // -----------------------------------------------------------------------------
@@ -201,6 +201,10 @@ string Paths::getCallHistoryFilePath () {
 	return getWritableFilePath(getAppCallHistoryFilePath());
 }
 
+string Paths::getCallStatsDirPath () {
+	return getWritableDirPath(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + Constants::PathCallStats);
+}
+
 string Paths::getCapturesDirPath () {
 	return getWritableDirPath(QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + Constants::PathCaptures);
 }
@@ -259,6 +263,10 @@ string Paths::getMessageHistoryFilePath () {
 	return getReadableFilePath(getAppMessageHistoryFilePath());// No need to ensure that the file exists as this DB is deprecated
 }
 
+string Paths::getMessageSearchIndexFilePath () {
+	return getWritableDirPath(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)) + Constants::PathMessageSearchIndex;
+}
+
 string Paths::getPackageDataDirPath () {
 	return getReadableDirPath(getAppPackageDataDirPath() + Constants::PathData);
 }
@@ -32,6 +32,7 @@ namespace Paths {
 	std::string getAssistantConfigDirPath ();
 	std::string getAvatarsDirPath ();
 	std::string getCallHistoryFilePath ();
+	std::string getCallStatsDirPath ();
 	std::string getCapturesDirPath ();
 	std::string getCodecsDirPath ();
 	std::string getConfigDirPath (bool writable = true);
@@ -43,6 +44,7 @@ namespace Paths {
 	std::string getLimeDatabasePath ();
 	std::string getLogsDirPath ();
 	std::string getMessageHistoryFilePath ();
+	std::string getMessageSearchIndexFilePath ();
 	std::string getPackageDataDirPath ();
 	std::string getPackageMsPluginsDirPath ();
 	std::string getPackagePluginsAppDirPath ();
@@ -23,6 +23,9 @@
 
 #include <QAbstractListModel>
 #include <QDebug>
+#include <QVector>
+
+#include <algorithm>
 
 #include "ProxyAbstractObject.hpp"
 
@@ -73,13 +76,43 @@ public:
 		endInsertRows();
 	}
 	
+	// QList keeps free space at both ends : prepending items one by one is amortized O(1) and doesn't copy the current list.
 	virtual void prepend(QList<T> items){
+		if(items.isEmpty())
+			return;
 		beginInsertRows(QModelIndex(), 0, items.size()-1);
-		items << mList;
-		mList = items;
+		mList.reserve(mList.size() + items.size());
+		for(auto itItem = items.rbegin() ; itItem != items.rend() ; ++itItem)
+			mList.prepend(*itItem);
+		endInsertRows();
+	}
+	
+	virtual void add(QList<T> items){
+		if(items.isEmpty())
+			return;
+		int row = mList.count();
+		beginInsertRows(QModelIndex(), row, row + items.size()-1);
+		mList.reserve(row + items.size());
+		mList << items;
 		endInsertRows();
 	}
 	
+	// Insert a contiguous range of items at 'row' with only one insertion signal.
+	virtual void insert(int row, QList<T> items){
+		if(row <= 0)
+			prepend(items);
+		else if(row >= mList.count())
+			add(items);
+		else if(!items.isEmpty()){
+			beginInsertRows(QModelIndex(), row, row + items.size()-1);
+			QList<T> tail = mList.mid(row);
+			mList.erase(mList.begin() + row, mList.end());
+			mList.reserve(mList.size() + items.size() + tail.size());
+			mList << items << tail;
+			endInsertRows();
+		}
+	}
+	
 // Remove functions
 	virtual bool removeRow (int row, const QModelIndex &parent = QModelIndex()){
 		return removeRows(row, 1, parent);
@@ -89,12 +122,25 @@ public:
 		if (row < 0 || count < 0 || limit >= mList.count())
 			return false;
 		beginRemoveRows(parent, row, limit);
-		for (int i = 0; i < count; ++i)
-			mList.takeAt(row);
+		mList.erase(mList.begin() + row, mList.begin() + row + count);
 		endRemoveRows();
 		return true;
 	}
 	
+	// Remove a set of rows with one removal signal by contiguous range. Ranges are removed from the last to keep rows valid.
+	virtual void removeRowRanges(QVector<int> rows){
+		std::sort(rows.begin(), rows.end());
+		rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+		int end = rows.size();
+		while(end > 0){
+			int begin = end - 1;
+			while(begin > 0 && rows[begin-1] == rows[begin] - 1)
+				--begin;
+			removeRows(rows[begin], end - begin);
+			end = begin;
+		}
+	}
+	
 	virtual void resetData(){
 		beginResetModel();
 		mList.clear();
@@ -24,6 +24,8 @@
 #include <QAbstractListModel>
 #include <QDebug>
 
+#include "app/tracer/ModelStats.hpp"
+
 // Use a regular declaration for Qt signal/slots handling
 class ProxyAbstractObject : public QAbstractListModel{
 	Q_OBJECT
@@ -33,6 +35,7 @@ public:
 	ProxyAbstractObject(QObject * parent = nullptr) : QAbstractListModel(parent){
 		connect(this, &ProxyAbstractObject::rowsInserted, this, &ProxyAbstractObject::countChanged);
 		connect(this, &ProxyAbstractObject::rowsRemoved, this, &ProxyAbstractObject::countChanged);
+		ModelStats::watch(this);
 	}
 	Q_INVOKABLE virtual int getCount() const{
 		return rowCount();
@@ -31,15 +31,106 @@ ProxyListModel::~ProxyListModel(){
 }
 
 QSharedPointer<QObject> ProxyListModel::get(QObject * itemToGet, int * index) const{
-	int row = 0;
-	for(auto item : mList)
-		if( item.get() == itemToGet){
-			if( index )
-				*index = row;
-			return item;
-		}else
-			++row;
-	return nullptr;
+	int row = indexOf(itemToGet);
+	if( row < 0)
+		return nullptr;
+	if( index )
+		*index = row;
+	return mList[row];
+}
+
+int ProxyListModel::indexOf(const QObject * item) const{
+	if( !mRowIndexEnabled){
+		int row = 0;
+		for(auto &listItem : mList)
+			if( listItem.get() == item)
+				return row;
+			else
+				++row;
+		return -1;
+	}
+	auto itRow = mRowIndex.constFind(item);
+	if( itRow != mRowIndex.constEnd()){
+		int row = itRow.value() + mRowIndexOffset;
+		if( row >= 0 && row < mList.size() && mList[row].get() == item)
+			return row;
+	}
+	rebuildRowIndex();
+	itRow = mRowIndex.constFind(item);
+	return itRow == mRowIndex.constEnd() ? -1 : itRow.value();
+}
+
+// -----------------------------------------------------------------------------
+
+void ProxyListModel::add(QSharedPointer<QObject> item){
+	int first = mList.size();
+	ProxyAbstractListModel::add(item);
+	indexAppendedRows(first);
+}
+
+void ProxyListModel::add(QList<QSharedPointer<QObject>> items){
+	int first = mList.size();
+	ProxyAbstractListModel::add(items);
+	indexAppendedRows(first);
+}
+
+void ProxyListModel::prepend(QSharedPointer<QObject> item){
+	prepend(QList<QSharedPointer<QObject>>{item});
+}
+
+void ProxyListModel::prepend(QList<QSharedPointer<QObject>> items){
+	ProxyAbstractListModel::prepend(items);
+	if( mRowIndexEnabled && !mRowIndex.isEmpty()){
+		mRowIndexOffset += items.size();
+		for(int row = 0 ; row < items.size() ; ++row)
+			mRowIndex[items[row].get()] = row - mRowIndexOffset;
+	}
+}
+
+bool ProxyListModel::removeRows (int row, int count, const QModelIndex &parent){
+	QList<QSharedPointer<QObject>> removedItems;
+	if( mRowIndexEnabled && !mRowIndex.isEmpty() && row >= 0 && count > 0 && row + count <= mList.size())
+		removedItems = mList.mid(row, count);
+	if( !ProxyAbstractListModel::removeRows(row, count, parent))
+		return false;
+	if( !removedItems.isEmpty()){
+		if( row == 0 || row == mList.size()){
+			for(auto &item : removedItems)
+				mRowIndex.remove(item.get());
+			if( row == 0)
+				mRowIndexOffset -= count;
+		}else// Next rows have been shifted.
+			mRowIndex.clear();
+	}
+	return true;
+}
+
+void ProxyListModel::resetData(){
+	ProxyAbstractListModel::resetData();
+	mRowIndex.clear();
+	mRowIndexOffset = 0;
+}
+
+// -----------------------------------------------------------------------------
+
+void ProxyListModel::setRowIndexEnabled(bool enabled){
+	mRowIndexEnabled = enabled;
+	mRowIndex.clear();
+	mRowIndexOffset = 0;
+}
+
+void ProxyListModel::rebuildRowIndex() const{
+	mRowIndex.clear();
+	mRowIndex.reserve(mList.size());
+	mRowIndexOffset = 0;
+	for(int row = 0 ; row < mList.size() ; ++row)
+		mRowIndex[mList[row].get()] = row;
+}
+
+void ProxyListModel::indexAppendedRows(int first) const{
+	if( mRowIndexEnabled && !mRowIndex.isEmpty())
+		for(int row = first ; row < mList.size() ; ++row)
+			mRowIndex[mList[row].get()] = row - mRowIndexOffset;
 }
 
 // -----------------------------------------------------------------------------
@@ -23,6 +23,7 @@
 
 
 #include "ProxyAbstractListModel.hpp"
+#include <QHash>
 #include <QSharedPointer>
 
 // =============================================================================
@@ -41,6 +42,7 @@ public:
 	}
 	
 	QSharedPointer<QObject> get(QObject * itemToGet, int * index = nullptr) const;
+	int indexOf(const QObject * item) const;// Return -1 if not found.
 	
 	template <class T>
 	QList<QSharedPointer<T>> getSharedList(){
@@ -58,34 +60,38 @@ public:
 			return QVariant::fromValue(mList[row].get());
 		return QVariant();
 	}
+	virtual void add(QSharedPointer<QObject> item) override;
+	virtual void add(QList<QSharedPointer<QObject>> items) override;
+	virtual void prepend(QSharedPointer<QObject> item) override;
+	virtual void prepend(QList<QSharedPointer<QObject>> items) override;
+	
 	template <class T>
 	void add(QSharedPointer<T> item){
-		ProxyAbstractListModel<QSharedPointer<QObject>>::add(item.template objectCast<QObject>());
+		add(item.template objectCast<QObject>());
+	}
+	
+	template <class T>
+	void add(const QList<QSharedPointer<T>>& items){
+		add(toObjectList(items));
 	}
 	
 	template <class T>
 	void prepend(QSharedPointer<T> item){
-		ProxyAbstractListModel<QSharedPointer<QObject>>::prepend(item.template objectCast<QObject>());
+		prepend(item.template objectCast<QObject>());
 	}
 	
 	template <class T>
-	void prepend(QList<QSharedPointer<T>> items){
-		beginInsertRows(QModelIndex(), 0, items.size()-1);
-		items << mList;
-		mList = items;
-		endInsertRows();
+	void prepend(const QList<QSharedPointer<T>>& items){
+		prepend(toObjectList(items));
 	}
 	
+// Remove functions
+	virtual bool removeRows (int row, int count, const QModelIndex &parent = QModelIndex()) override;
+	virtual void resetData() override;
+	
 	virtual bool remove(QObject *itemToRemove) override{
-		bool removed = false;
-		qInfo() << QStringLiteral("Removing ") << itemToRemove->metaObject()->className() << QStringLiteral(" : ") << itemToRemove;
-		int index = 0;
-		for(auto item : mList)
-			if( item == itemToRemove) {
-				removed = removeRow(index);
-				break;
-			}else
-				++index;
+		int row = indexOf(itemToRemove);
+		bool removed = row >= 0 && removeRow(row);
 		if( !removed)
 			qWarning() << QStringLiteral("Unable to remove ") << itemToRemove->metaObject()->className() << QStringLiteral(" : ") << itemToRemove;
 		return removed;
@@ -93,6 +99,40 @@ public:
 	virtual bool remove(QSharedPointer<QObject> itemToRemove){
 		return remove(itemToRemove.get());
 	}
+	// Remove all items that are in the list with one removal signal by contiguous range.
+	template <class T>
+	void remove(const QList<QSharedPointer<T>>& items){
+		QVector<int> rows;
+		rows.reserve(items.size());
+		for(auto item : items){
+			int row = indexOf(item.get());
+			if( row >= 0)
+				rows << row;
+		}
+		removeRowRanges(rows);
+	}
+	
+protected:
+	// The row index gives O(1) lookups of items (get, indexOf, remove). It is kept up to date on insertions and removals at both ends.
+	// Each lookup is checked against mList : other changes, including direct changes on mList from subclasses, only make it rebuilt on the next lookup.
+	void setRowIndexEnabled(bool enabled);
+	
+	template <class T>
+	static QList<QSharedPointer<QObject>> toObjectList(const QList<QSharedPointer<T>>& items){
+		QList<QSharedPointer<QObject>> objects;
+		objects.reserve(items.size());
+		for(auto item : items)
+			objects << item.template objectCast<QObject>();
+		return objects;
+	}
+	
+private:
+	void rebuildRowIndex() const;
+	void indexAppendedRows(int first) const;
+	
+	bool mRowIndexEnabled = false;
+	mutable QHash<const QObject*, int> mRowIndex;	// Rows are stored minus mRowIndexOffset : prepending items doesn't update the other rows.
+	mutable int mRowIndexOffset = 0;
 };
 
 #endif
@@ -20,10 +20,13 @@
 
 #include "SortFilterProxyModel.hpp"
 
+#include "app/tracer/ModelStats.hpp"
+
 SortFilterProxyModel::SortFilterProxyModel(QObject * parent) : QSortFilterProxyModel(parent){
 	mFilterType = 0;
 	connect(this, &SortFilterProxyModel::rowsInserted, this, &SortFilterProxyModel::countChanged);
 	connect(this, &SortFilterProxyModel::rowsRemoved, this, &SortFilterProxyModel::countChanged);
+	ModelStats::watch(this);
 }
 
 int SortFilterProxyModel::getCount() const{
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2022 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+
+#include <QAbstractItemModel>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QTimer>
+
+#include "ModelStats.hpp"
+
+// =============================================================================
+
+std::atomic<bool> ModelStats::mEnabled(false);
+QElapsedTimer ModelStats::mTimer;
+QTimer *ModelStats::mDumpTimer = nullptr;
+QHash<const QAbstractItemModel *, ModelStats::Counters> ModelStats::mInstances;
+QHash<QByteArray, ModelStats::Counters> ModelStats::mReleasedInstances;
+QHash<QByteArray, int> ModelStats::mReleasedInstancesCount;
+
+// -----------------------------------------------------------------------------
+
+void ModelStats::init (bool enabled, int dumpInterval) {
+	if (enabled && !mTimer.isValid())
+		mTimer.start();
+	mEnabled = enabled;
+	if (enabled && dumpInterval > 0) {
+		if (!mDumpTimer) {
+			mDumpTimer = new QTimer(QCoreApplication::instance());
+			QObject::connect(mDumpTimer, &QTimer::timeout, [] {
+				dump();
+			});
+		}
+		mDumpTimer->start(dumpInterval * 1000);
+	} else if (mDumpTimer)
+		mDumpTimer->stop();
+	if (enabled)
+		qInfo() << QStringLiteral("Model stats enabled (dump interval: %1 s).").arg(dumpInterval);
+}
+
+qint64 ModelStats::getTimestamp () {
+	return mTimer.nsecsElapsed();
+}
+
+void ModelStats::watch (QAbstractItemModel *model) {
+	if (!isEnabled())
+		return;
+	using Model = QAbstractItemModel;
+	QObject::connect(model, &Model::modelReset, [model] {
+		count(model, ResetCounter);
+	});
+	QObject::connect(model, &Model::layoutChanged, [model] {
+		count(model, LayoutCounter);
+	});
+	QObject::connect(model, &Model::rowsInserted, [model](const QModelIndex &, int first, int last) {
+		count(model, InsertCounter);
+		count(model, InsertedRowsCounter, last - first + 1);
+	});
+	QObject::connect(model, &Model::rowsRemoved, [model](const QModelIndex &, int first, int last) {
+		count(model, RemoveCounter);
+		count(model, RemovedRowsCounter, last - first + 1);
+	});
+	QObject::connect(model, &Model::rowsMoved, [model] {
+		count(model, MoveCounter);
+	});
+	QObject::connect(model, &Model::dataChanged, [model](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+		count(model, DataChangedCounter);
+		count(model, DataChangedRowsCounter, bottomRight.row() - topLeft.row() + 1);
+	});
+	QObject::connect(model, &QObject::destroyed, [model] {
+		release(model);
+	});
+}
+
+// -----------------------------------------------------------------------------
+
+ModelStats::Counters &ModelStats::getCounters (const QAbstractItemModel *model) {
+	Counters &counters = mInstances[model];
+	if (counters.className.isEmpty())// Resolved on the first count : the instance is fully constructed.
+		counters.className = model->metaObject()->className();
+	return counters;
+}
+
+void ModelStats::count (const QAbstractItemModel *model, Counter counter, qint64 rows) {
+	getCounters(model).values[counter] += (rows > 0 ? rows : 1);
+}
+
+void ModelStats::addTiming (const QAbstractItemModel *model, Timing timing, qint64 duration) {
+	Counters &counters = getCounters(model);
+	if (timing == FilterTiming) {
+		++counters.values[FilterCallsCounter];
+		counters.values[FilterTimeCounter] += duration;
+	} else {
+		++counters.values[SortCallsCounter];
+		counters.values[SortTimeCounter] += duration;
+	}
+}
+
+void ModelStats::release (const QAbstractItemModel *model) {
+	auto it = mInstances.find(model);
+	if (it == mInstances.end())// Nothing has been counted.
+		return;
+	Counters &total = mReleasedInstances[it->className];
+	for (int i = 0; i < CounterCount; ++i)
+		total.values[i] += it->values[i];
+	++mReleasedInstancesCount[it->className];
+	mInstances.erase(it);
+}
+
+// -----------------------------------------------------------------------------
+
+QString ModelStats::toString (const Counters &counters) {
+	const qint64 *values = counters.values;
+	return QStringLiteral("resets: %1, layout changes: %2, insertions: %3 (%4 rows), removals: %5 (%6 rows), moves: %7, data changes: %8 (%9 rows)")
+		.arg(values[ResetCounter]).arg(values[LayoutCounter])
+		.arg(values[InsertCounter]).arg(values[InsertedRowsCounter])
+		.arg(values[RemoveCounter]).arg(values[RemovedRowsCounter])
+		.arg(values[MoveCounter])
+		.arg(values[DataChangedCounter]).arg(values[DataChangedRowsCounter])
+		+ QStringLiteral(", filterAcceptsRow: %1 calls in %2 ms, lessThan: %3 calls in %4 ms")
+		.arg(values[FilterCallsCounter]).arg(values[FilterTimeCounter] / 1e6, 0, 'f', 3)
+		.arg(values[SortCallsCounter]).arg(values[SortTimeCounter] / 1e6, 0, 'f', 3);
+}
+
+QString ModelStats::getReport () {
+	struct ClassCounters {
+		Counters total;
+		QList<const QAbstractItemModel *> instances;
+	};
+	QHash<QByteArray, ClassCounters> classes;
+	for (auto it = mReleasedInstances.cbegin(); it != mReleasedInstances.cend(); ++it)
+		classes[it.key()].total = it.value();
+	for (auto it = mInstances.cbegin(); it != mInstances.cend(); ++it) {
+		ClassCounters &classCounters = classes[it->className];
+		for (int i = 0; i < CounterCount; ++i)
+			classCounters.total.values[i] += it->values[i];
+		classCounters.instances << it.key();
+	}
+	// Classes that reset or change their layout the most come first.
+	QList<QByteArray> classNames = classes.keys();
+	std::sort(classNames.begin(), classNames.end(), [&classes](const QByteArray &a, const QByteArray &b) {
+		const qint64 *aValues = classes[a].total.values;
+		const qint64 *bValues = classes[b].total.values;
+		qint64 aCount = aValues[ResetCounter] + aValues[LayoutCounter];
+		qint64 bCount = bValues[ResetCounter] + bValues[LayoutCounter];
+		return aCount > bCount || (aCount == bCount && a < b);
+	});
+
+	QString report = QStringLiteral("Model stats over %1 s:").arg(mTimer.elapsed() / 1000);
+	for (const auto &className : classNames) {
+		const ClassCounters &classCounters = classes[className];
+		report += QStringLiteral("\n%1 (%2 alive, %3 destroyed): %4")
+			.arg(QString::fromLatin1(className))
+			.arg(classCounters.instances.size())
+			.arg(mReleasedInstancesCount.value(className))
+			.arg(toString(classCounters.total));
+		if (classCounters.instances.size() > 1)
+			for (auto model : classCounters.instances)
+				report += QStringLiteral("\n\t0x%1: %2")
+					.arg(quintptr(model), 0, 16)
+					.arg(toString(mInstances[model]));
+	}
+	return report;
+}
+
+bool ModelStats::dump (const QString &filePath) {
+	if (!mTimer.isValid()) {
+		qWarning() << QStringLiteral("Model stats are not enabled. Start the application with `--model-stats` to count model signals.");
+		return false;
+	}
+	const QString report = getReport();
+	if (filePath.isEmpty()) {
+		for (const auto &line : report.split('\n'))
+			qInfo().noquote() << line;
+		return true;
+	}
+	QFile file(filePath);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+		qWarning() << QStringLiteral("Unable to open model stats file: `%1`.").arg(filePath);
+		return false;
+	}
+	file.write(report.toUtf8());
+	qInfo() << QStringLiteral("Model stats written to: `%1`.").arg(filePath);
+	return true;
+}
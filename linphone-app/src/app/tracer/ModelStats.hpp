@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2022 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef MODEL_STATS_H_
+#define MODEL_STATS_H_
+
+#include <atomic>
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QString>
+
+// =============================================================================
+// Counters of model signals (resets, layout changes, row insertions, removals,
+// moves and data changes) and of the time spent in filterAcceptsRow/lessThan,
+// by model class and instance. Models are only watched when the application is
+// started with `--model-stats`. Counters are logged periodically and on demand
+// with the `dump-model-stats` command. Models are expected in the GUI thread.
+// =============================================================================
+
+class QAbstractItemModel;
+class QTimer;
+
+class ModelStats {
+public:
+	enum Timing {
+		FilterTiming,
+		SortTiming
+	};
+
+	// Time a filterAcceptsRow or lessThan call.
+	class Scope {
+	public:
+		Scope (const QAbstractItemModel *model, Timing timing) : mModel(model), mTiming(timing) {
+			if (ModelStats::isEnabled())
+				mStart = ModelStats::getTimestamp();
+		}
+
+		~Scope () {
+			if (mStart >= 0)
+				ModelStats::addTiming(mModel, mTiming, ModelStats::getTimestamp() - mStart);
+		}
+
+	private:
+		Scope (const Scope &) = delete;
+		Scope &operator= (const Scope &) = delete;
+
+		const QAbstractItemModel *mModel;
+		Timing mTiming;
+		qint64 mStart = -1;
+	};
+
+	// Log counters every `dumpInterval` seconds. 0 means only on demand.
+	static void init (bool enabled, int dumpInterval = 0);
+
+	static bool isEnabled () {
+		return mEnabled.load(std::memory_order_relaxed);
+	}
+
+	// Count the signals of the model. Can be called from base constructors : the class name is resolved on first use.
+	static void watch (QAbstractItemModel *model);
+
+	static QString getReport ();
+	// Write the report into `filePath` or into logs if empty. Return false on error.
+	static bool dump (const QString &filePath = QString());
+
+private:
+	enum Counter {
+		ResetCounter,
+		LayoutCounter,
+		InsertCounter,
+		InsertedRowsCounter,
+		RemoveCounter,
+		RemovedRowsCounter,
+		MoveCounter,
+		DataChangedCounter,
+		DataChangedRowsCounter,
+		FilterCallsCounter,
+		FilterTimeCounter,	// In nanoseconds.
+		SortCallsCounter,
+		SortTimeCounter,	// In nanoseconds.
+		CounterCount
+	};
+
+	struct Counters {
+		QByteArray className;
+		qint64 values[CounterCount] = {};
+	};
+
+	ModelStats () = default;
+
+	static qint64 getTimestamp ();
+	static Counters &getCounters (const QAbstractItemModel *model);
+	static void count (const QAbstractItemModel *model, Counter counter, qint64 rows = 0);
+	static void addTiming (const QAbstractItemModel *model, Timing timing, qint64 duration);
+	static void release (const QAbstractItemModel *model);
+	static QString toString (const Counters &counters);
+
+	static std::atomic<bool> mEnabled;
+	static QElapsedTimer mTimer;
+	static QTimer *mDumpTimer;
+	static QHash<const QAbstractItemModel *, Counters> mInstances;
+	static QHash<QByteArray, Counters> mReleasedInstances;	// Totals of destroyed instances by class.
+	static QHash<QByteArray, int> mReleasedInstancesCount;
+};
+
+#endif // MODEL_STATS_H_
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2022 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "config.h"
+
+#include "app/paths/Paths.hpp"
+#include "utils/Utils.hpp"
+
+#include "Tracer.hpp"
+
+// =============================================================================
+
+namespace {
+	constexpr char TraceFileName[] = "startup-trace.json";
+	constexpr int MainThreadId = 1;
+}
+
+constexpr char Tracer::StartupCategory[];
+
+std::atomic<bool> Tracer::mEnabled(false);
+QElapsedTimer Tracer::mTimer;
+QMutex Tracer::mMutex;
+QVector<Tracer::Event> Tracer::mEvents;
+
+// -----------------------------------------------------------------------------
+
+void Tracer::init (bool enabled) {
+	if (enabled && !mTimer.isValid()) {
+		mTimer.start();
+		getThreadId();// The first traced thread is the GUI thread.
+		mEvents.reserve(256);
+	}
+	mEnabled = enabled;
+	if (enabled)
+		qInfo() << QStringLiteral("Startup tracing enabled.");
+}
+
+qint64 Tracer::getTimestamp () {
+	return mTimer.nsecsElapsed() / 1000;
+}
+
+int Tracer::getThreadId () {
+	static std::atomic<int> threadCount(0);
+	thread_local int threadId = ++threadCount;
+	return threadId;
+}
+
+void Tracer::addSpan (const char *name, const char *category, qint64 start, qint64 duration) {
+	Event event{ name, category, start, duration, getThreadId() };
+	QMutexLocker locker(&mMutex);
+	mEvents << event;
+}
+
+// -----------------------------------------------------------------------------
+
+QString Tracer::getDefaultFilePath () {
+	return Utils::coreStringToAppString(Paths::getLogsDirPath()) + TraceFileName;
+}
+
+bool Tracer::dump (const QString &filePath) {
+	if (!mTimer.isValid()) {
+		qWarning() << QStringLiteral("Tracing is not enabled. Start the application with `--trace` to record spans.");
+		return false;
+	}
+	const qint64 pid = QCoreApplication::applicationPid();
+	QJsonArray traceEvents;
+	int threadCount = 0;
+	{
+		QMutexLocker locker(&mMutex);
+		for (const auto &event : mEvents) {
+			traceEvents.append(QJsonObject{
+				{ "name", QString::fromLatin1(event.name) },
+				{ "cat", QString::fromLatin1(event.category) },
+				{ "ph", "X" },
+				{ "ts", event.start },
+				{ "dur", event.duration },
+				{ "pid", pid },
+				{ "tid", event.threadId }
+			});
+			threadCount = qMax(threadCount, event.threadId);
+		}
+	}
+	traceEvents.append(QJsonObject{
+		{ "name", "process_name" }, { "ph", "M" }, { "pid", pid },
+		{ "args", QJsonObject{ { "name", EXECUTABLE_NAME } } }
+	});
+	for (int threadId = 1; threadId <= threadCount; ++threadId)
+		traceEvents.append(QJsonObject{
+			{ "name", "thread_name" }, { "ph", "M" }, { "pid", pid }, { "tid", threadId },
+			{ "args", QJsonObject{ { "name", threadId == MainThreadId ? QStringLiteral("GUI") : QStringLiteral("Thread %1").arg(threadId) } } }
+		});
+
+	QFile file(filePath);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		qWarning() << QStringLiteral("Unable to open trace file: `%1`.").arg(filePath);
+		return false;
+	}
+	file.write(QJsonDocument(QJsonObject{
+		{ "traceEvents", traceEvents },
+		{ "displayTimeUnit", "ms" }
+	}).toJson(QJsonDocument::Compact));
+	qInfo() << QStringLiteral("Trace written to: `%1`.").arg(filePath);
+	return true;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2022 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRACER_H_
+#define TRACER_H_
+
+#include <atomic>
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+// =============================================================================
+// Scoped spans recorder. Spans are only recorded when the tracer is enabled
+// (`--trace` option) and can be dumped in the Chrome `trace_event` format
+// (chrome://tracing, Perfetto).
+// =============================================================================
+
+class Tracer {
+public:
+	class Span {
+	public:
+		Span (const char *name, const char *category = Tracer::StartupCategory) : mName(name), mCategory(category) {
+			if (Tracer::isEnabled())
+				mStart = Tracer::getTimestamp();
+		}
+
+		~Span () {
+			if (mStart >= 0)
+				Tracer::addSpan(mName, mCategory, mStart, Tracer::getTimestamp() - mStart);
+		}
+
+	private:
+		Span (const Span &) = delete;
+		Span &operator= (const Span &) = delete;
+
+		const char *mName;
+		const char *mCategory;
+		qint64 mStart = -1;
+	};
+
+	static constexpr char StartupCategory[] = "startup";
+
+	static void init (bool enabled);
+
+	static bool isEnabled () {
+		return mEnabled.load(std::memory_order_relaxed);
+	}
+
+	// Write all recorded spans into `filePath`. Return false on error.
+	static bool dump (const QString &filePath);
+
+	static QString getDefaultFilePath ();
+
+private:
+	struct Event {
+		const char *name;
+		const char *category;
+		qint64 start;	// In microseconds.
+		qint64 duration;	// In microseconds.
+		int threadId;
+	};
+
+	Tracer () = default;
+
+	static qint64 getTimestamp ();
+	static int getThreadId ();
+	static void addSpan (const char *name, const char *category, qint64 start, qint64 duration);
+
+	static std::atomic<bool> mEnabled;
+	static QElapsedTimer mTimer;
+	static QMutex mMutex;
+	static QVector<Event> mEvents;
+};
+
+#endif // TRACER_H_
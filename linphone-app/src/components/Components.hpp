@@ -29,6 +29,7 @@
 #include "camera/Camera.hpp"
 #include "components/chat-events/ChatCallModel.hpp"
 #include "components/chat-events/ChatMessageModel.hpp"
+#include "components/chat-events/ChatMessageStub.hpp"
 #include "components/chat-events/ChatNoticeModel.hpp"
 #include "chat-room/ChatRoomProxyModel.hpp"
 #include "codecs/AudioCodecsModel.hpp"
@@ -73,6 +74,7 @@
 #include "recorder/RecorderManager.hpp"
 #include "settings/AccountSettingsModel.hpp"
 #include "settings/SettingsModel.hpp"
+#include "search/MessageSearchIndex.hpp"
 #include "search/SearchResultModel.hpp"
 #include "sip-addresses/SipAddressesModel.hpp"
 #include "sip-addresses/SipAddressesProxyModel.hpp"
@@ -58,6 +58,20 @@ CallModel::CallModel (shared_ptr<linphone::Call> call){
 	
 	CoreManager *coreManager = CoreManager::getInstance();
 	
+	const int statsHistorySize = coreManager->getSettingsModel()->getCallStatsHistoryDuration() * 1000 / CallStatsHistory::SamplingInterval;
+	mAudioStatsHistory.setCapacity(statsHistorySize);
+	mVideoStatsHistory.setCapacity(statsHistorySize);
+	mStatsRecordingEnabled = coreManager->getSettingsModel()->getCallStatsRecordingEnabled();
+	
+	if (mCall) {
+		if (!isOutgoing())
+			mSetupTimings.mark(CallSetupTimings::IncomingReceived);
+		else {	// Get marks done by the call launcher.
+			mSetupTimings = CallSetupTimings::takePending();
+			mSetupTimings.mark(CallSetupTimings::Launched);
+		}
+	}
+	
 	// Deal with auto-answer.
 	if (!isOutgoing()) {
 		SettingsModel *settings = coreManager->getSettingsModel();
@@ -201,21 +215,105 @@ void CallModel::setRecordFile (const shared_ptr<linphone::CallParams> &callParam
 
 // -----------------------------------------------------------------------------
 
+// Called on each stats update : only record typed values while no stats are displayed.
 void CallModel::updateStats (const shared_ptr<const linphone::CallStats> &callStats) {
+	if (!mSetupTimings.isMarked(CallSetupTimings::FirstRtpReceived)
+		&& callStats->getType() == linphone::StreamType::Audio && callStats->getDownloadBandwidth() > 0)
+		markSetupPhase(CallSetupTimings::FirstRtpReceived);
+	
 	switch (callStats->getType()) {
 		case linphone::StreamType::Text:
 		case linphone::StreamType::Unknown:
-			break;
+			return;
 			
 		case linphone::StreamType::Audio:
-			updateStats(callStats, mAudioStats);
+			recordStats(callStats);
+			mAudioStatsHistory.add(createStatsSample(callStats));
+			if (mStatsViewers > 0)
+				updateStats(callStats, mAudioStats);
 			break;
 		case linphone::StreamType::Video:
-			updateStats(callStats, mVideoStats);
+			recordStats(callStats);
+			mVideoStatsHistory.add(createStatsSample(callStats));
+			if (mStatsViewers > 0)
+				updateStats(callStats, mVideoStats);
 			break;
 	}
 	
-	emit statsUpdated();
+	if (mStatsViewers > 0)
+		emit statsUpdated();
+}
+
+// The recording file is created with the first stats : calls without media have no file.
+void CallModel::recordStats (const shared_ptr<const linphone::CallStats> &callStats) {
+	if (!mStatsRecordingEnabled || !mCall)
+		return;
+	if (!mStatsRecorder) {
+		if (mCall->getState() == linphone::Call::State::End || mCall->getState() == linphone::Call::State::Released)
+			return;
+		mStatsRecorder.reset(new CallStatsRecorder(
+					CallStatsRecorder::getDirPath() + generateSavedFilename() + ".stats",
+					getFullPeerAddress(), getFullLocalAddress()));
+	}
+	shared_ptr<const linphone::PayloadType> payloadType = callStats->getType() == linphone::StreamType::Audio
+			? mCall->getCurrentParams()->getUsedAudioPayloadType()
+			: mCall->getCurrentParams()->getUsedVideoPayloadType();
+	mStatsRecorder->add(callStats, payloadType
+						? QStringLiteral("%1/%2").arg(Utils::coreStringToAppString(payloadType->getMimeType())).arg(payloadType->getClockRate())
+						: QString(""));
+}
+
+void CallModel::markSetupPhase (CallSetupTimings::Phase phase) {
+	if (mSetupTimings.isMarked(phase))
+		return;
+	mSetupTimings.mark(phase);
+	emit setupTimingsChanged();
+	if (phase == CallSetupTimings::FirstRtpReceived)
+		qInfo() << QStringLiteral("Call setup timings:") << getFullPeerAddress() << mSetupTimings.toString();
+}
+
+QVariantMap CallModel::getSetupTimingsMap () const {
+	return mSetupTimings.toVariantMap();
+}
+
+bool CallModel::getStatsVisible () const {
+	return mStatsViewers > 0;
+}
+
+void CallModel::increaseStatsViewers () {
+	if (mStatsViewers++ > 0)
+		return;
+	if (mCall) {	// Build strings from the current stats.
+		shared_ptr<const linphone::CallStats> audioStats = mCall->getAudioStats();
+		shared_ptr<const linphone::CallStats> videoStats = mCall->getVideoStats();
+		if (audioStats)
+			updateStats(audioStats, mAudioStats);
+		if (videoStats)
+			updateStats(videoStats, mVideoStats);
+		emit statsUpdated();
+	}
+	emit statsVisibleChanged();
+}
+
+void CallModel::decreaseStatsViewers () {
+	if (mStatsViewers <= 0)
+		return;
+	if (--mStatsViewers == 0)
+		emit statsVisibleChanged();
+}
+
+QVariantList CallModel::getStatsSeries (const QString &stream, const QString &field) const {
+	CallStatsHistory::Field statsField;
+	if (!CallStatsHistory::getField(field, &statsField)) {
+		qWarning() << QStringLiteral("Unknown call stats field: `%1`.").arg(field);
+		return QVariantList();
+	}
+	if (stream == QLatin1String("audio"))
+		return mAudioStatsHistory.getSeries(statsField);
+	if (stream == QLatin1String("video"))
+		return mVideoStatsHistory.getSeries(statsField);
+	qWarning() << QStringLiteral("Unknown call stream: `%1`.").arg(stream);
+	return QVariantList();
 }
 
 // -----------------------------------------------------------------------------
@@ -391,12 +489,31 @@ void CallModel::handleCallStateChanged (const shared_ptr<linphone::Call> &call,
 	
 	updateIsInConference();
 	
+	switch (state) {
+		case linphone::Call::State::OutgoingProgress:
+			markSetupPhase(CallSetupTimings::OutgoingProgress);
+			break;
+		case linphone::Call::State::OutgoingRinging:
+		case linphone::Call::State::OutgoingEarlyMedia:
+			markSetupPhase(CallSetupTimings::Ringing);
+			break;
+		case linphone::Call::State::Connected:
+			markSetupPhase(CallSetupTimings::Connected);
+			break;
+		case linphone::Call::State::StreamsRunning:
+			markSetupPhase(CallSetupTimings::StreamsRunning);
+			break;
+		default:
+			break;
+	}
+	
 	switch (state) {
 		case linphone::Call::State::Error:
 		case linphone::Call::State::End:
 			setCallErrorFromReason(call->getReason());
 			stopAutoAnswerTimer();
 			stopRecording();
+			mStatsRecorder.reset();
 			mPausedByRemote = false;
 			break;
 			
@@ -975,6 +1092,31 @@ static inline QVariantMap createStat (const QString &key, const QString &value)
 	return m;
 }
 
+CallStatsHistory::Sample CallModel::createStatsSample (const shared_ptr<const linphone::CallStats> &callStats) const {
+	CallStatsHistory::Sample sample;
+	sample.timestamp = QDateTime::currentMSecsSinceEpoch();
+	sample.uploadBandwidth = callStats->getUploadBandwidth();
+	sample.downloadBandwidth = callStats->getDownloadBandwidth();
+	sample.senderLossRate = callStats->getSenderLossRate();
+	sample.receiverLossRate = callStats->getReceiverLossRate();
+	switch (callStats->getType()) {
+		case linphone::StreamType::Audio:
+			sample.jitterBufferSize = callStats->getJitterBufferSizeMs();
+			break;
+		case linphone::StreamType::Video: {
+			sample.estimatedDownloadBandwidth = callStats->getEstimatedDownloadBandwidth();
+			if (mCall) {
+				shared_ptr<const linphone::CallParams> params = mCall->getCurrentParams();
+				sample.receivedFramerate = params->getReceivedFramerate();
+				sample.sentFramerate = params->getSentFramerate();
+			}
+		} break;
+		default:
+			break;
+	}
+	return sample;
+}
+
 void CallModel::updateStats (const shared_ptr<const linphone::CallStats> &callStats, QVariantList &statsList) {
 	if(mCall){
 		shared_ptr<const linphone::CallParams> params = mCall->getCurrentParams();
@@ -25,6 +25,9 @@
 #include <QSharedPointer>
 #include <linphone++/linphone.hh>
 #include "../search/SearchListener.hpp"
+#include "CallSetupTimings.hpp"
+#include "CallStatsHistory.hpp"
+#include "CallStatsRecorder.hpp"
 
 #include "utils/LinphoneEnums.hpp"
 
@@ -75,6 +78,8 @@ class CallModel : public QObject {
 	
 	Q_PROPERTY(QVariantList audioStats READ getAudioStats NOTIFY statsUpdated)
 	Q_PROPERTY(QVariantList videoStats READ getVideoStats NOTIFY statsUpdated)
+	Q_PROPERTY(bool statsVisible READ getStatsVisible NOTIFY statsVisibleChanged)	// Stats strings are only built while at least one view shows them.
+	Q_PROPERTY(QVariantMap setupTimings READ getSetupTimingsMap NOTIFY setupTimingsChanged)	// Phase name to ms since the call start.
 	
 	Q_PROPERTY(CallEncryption encryption READ getEncryption NOTIFY securityUpdated)
 	Q_PROPERTY(bool isSecured READ isSecured NOTIFY securityUpdated)
@@ -134,6 +139,24 @@ public:
 	
 	void updateStats (const std::shared_ptr<const linphone::CallStats> &callStats);
 	
+	const CallStatsHistory &getAudioStatsHistory () const {
+		return mAudioStatsHistory;
+	}
+	const CallStatsHistory &getVideoStatsHistory () const {
+		return mVideoStatsHistory;
+	}
+	const CallSetupTimings &getSetupTimings () const {
+		return mSetupTimings;
+	}
+	void markSetupPhase (CallSetupTimings::Phase phase);
+	QVariantMap getSetupTimingsMap () const;
+	
+	// Trend of a stats field ("uploadBandwidth", "receiverLossRate"...) of the "audio" or "video" stream.
+	Q_INVOKABLE QVariantList getStatsSeries (const QString &stream, const QString &field) const;
+	// Each opened stats view holds a reference.
+	Q_INVOKABLE void increaseStatsViewers ();
+	Q_INVOKABLE void decreaseStatsViewers ();
+	
 	void notifyCameraFirstFrameReceived (unsigned int width, unsigned int height);
 	
 	Q_INVOKABLE void accept ();
@@ -195,6 +218,8 @@ signals:
 	void recordingChanged (bool status);
 	void snapshotEnabledChanged();
 	void statsUpdated ();
+	void statsVisibleChanged ();
+	void setupTimingsChanged ();
 	void statusChanged (CallStatus status);
 	void videoRequested ();
 	void securityUpdated ();
@@ -266,6 +291,10 @@ public:
 	QVariantList getAudioStats () const;
 	QVariantList getVideoStats () const;
 	void updateStats (const std::shared_ptr<const linphone::CallStats> &callStats, QVariantList &statsList);
+	CallStatsHistory::Sample createStatsSample (const std::shared_ptr<const linphone::CallStats> &callStats) const;
+	void recordStats (const std::shared_ptr<const linphone::CallStats> &callStats);
+	
+	bool getStatsVisible () const;
 	
 	QString iceStateToString (linphone::IceState state) const;
 	
@@ -295,6 +324,12 @@ private:
 	
 	QVariantList mAudioStats;
 	QVariantList mVideoStats;
+	CallStatsHistory mAudioStatsHistory;
+	CallStatsHistory mVideoStatsHistory;
+	int mStatsViewers = 0;
+	std::unique_ptr<CallStatsRecorder> mStatsRecorder;
+	CallSetupTimings mSetupTimings;
+	bool mStatsRecordingEnabled = false;
 	std::shared_ptr<SearchListener> mSearch;
 	QString mTransferAddress;
 	QSharedPointer<ConferenceModel> mConferenceModel;
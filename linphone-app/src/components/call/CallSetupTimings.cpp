@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2022 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QVariantList>
+
+#include "CallSetupTimings.hpp"
+
+// =============================================================================
+
+namespace {
+	// Upper bounds (ms) of histogram buckets. The last bucket is unbounded.
+	constexpr qint64 HistogramBuckets[] = { 100, 250, 500, 1000, 2000, 3000, 5000, 10000, 30000 };
+	
+	constexpr char PhaseNames[][20] = {
+		"launched",
+		"addressInterpreted",
+		"invited",
+		"incomingReceived",
+		"outgoingProgress",
+		"ringing",
+		"connected",
+		"streamsRunning",
+		"firstRtpReceived"
+	};
+	static_assert(sizeof(PhaseNames) / sizeof(PhaseNames[0]) == CallSetupTimings::PhaseCount, "Missing phase name.");
+	
+	qint64 getPercentile (const QVector<qint64> &sortedValues, int percentile) {
+		const int index = (sortedValues.size() * percentile + 99) / 100 - 1;
+		return sortedValues[qBound(0, index, sortedValues.size() - 1)];
+	}
+}
+
+CallSetupTimings::CallSetupTimings () {
+	std::fill(mTimestamps, mTimestamps + PhaseCount, -1);
+}
+
+qint64 CallSetupTimings::getTimestamp () {
+	static QElapsedTimer timer;
+	if (!timer.isValid())
+		timer.start();
+	return timer.elapsed();
+}
+
+void CallSetupTimings::mark (Phase phase) {
+	if (mTimestamps[phase] >= 0)
+		return;
+	mTimestamps[phase] = getTimestamp();
+	if (mStart < 0)
+		mStart = mTimestamps[phase];
+}
+
+qint64 CallSetupTimings::getElapsed (Phase phase) const {
+	return mTimestamps[phase] < 0 ? -1 : mTimestamps[phase] - mStart;
+}
+
+const char *CallSetupTimings::getPhaseName (Phase phase) {
+	return PhaseNames[phase];
+}
+
+QVariantMap CallSetupTimings::toVariantMap () const {
+	QVariantMap map;
+	for (int phase = 0; phase < PhaseCount; ++phase)
+		if (mTimestamps[phase] >= 0)
+			map[PhaseNames[phase]] = getElapsed(Phase(phase));
+	return map;
+}
+
+QString CallSetupTimings::toString () const {
+	QStringList phases;
+	for (int phase = 0; phase < PhaseCount; ++phase)
+		if (mTimestamps[phase] >= 0)
+			phases << QStringLiteral("%1=%2ms").arg(PhaseNames[phase]).arg(getElapsed(Phase(phase)));
+	return phases.join(", ");
+}
+
+CallSetupTimings &CallSetupTimings::getPending () {
+	static CallSetupTimings pending;
+	return pending;
+}
+
+CallSetupTimings CallSetupTimings::takePending () {
+	CallSetupTimings timings = getPending();
+	getPending() = CallSetupTimings();
+	return timings;
+}
+
+// -----------------------------------------------------------------------------
+
+CallSetupHistograms::CallSetupHistograms (int window) : mWindow(qMax(1, window)) {
+	mValues.resize(CallSetupTimings::PhaseCount);
+	mNextIndexes.fill(0, CallSetupTimings::PhaseCount);
+}
+
+void CallSetupHistograms::add (const CallSetupTimings &timings) {
+	for (int phase = 0; phase < CallSetupTimings::PhaseCount; ++phase) {
+		const qint64 elapsed = timings.getElapsed(CallSetupTimings::Phase(phase));
+		if (elapsed < 0)
+			continue;
+		QVector<qint64> &values = mValues[phase];
+		if (values.size() < mWindow)
+			values << elapsed;
+		else {	// Replace the oldest value.
+			values[mNextIndexes[phase]] = elapsed;
+			mNextIndexes[phase] = (mNextIndexes[phase] + 1) % mWindow;
+		}
+	}
+}
+
+QVariantMap CallSetupHistograms::toVariantMap () const {
+	QVariantMap map;
+	for (int phase = 0; phase < CallSetupTimings::PhaseCount; ++phase) {
+		QVector<qint64> values = mValues[phase];
+		if (values.isEmpty())
+			continue;
+		std::sort(values.begin(), values.end());
+		
+		QVariantList buckets;
+		int index = 0;
+		for (qint64 bound : HistogramBuckets) {
+			int count = 0;
+			for (; index < values.size() && values[index] <= bound; ++index)
+				++count;
+			buckets << QVariantMap{ { "le", bound }, { "count", count } };
+		}
+		buckets << QVariantMap{ { "le", -1 }, { "count", values.size() - index } };
+		
+		map[CallSetupTimings::getPhaseName(CallSetupTimings::Phase(phase))] = QVariantMap{
+			{ "count", values.size() },
+			{ "p50", getPercentile(values, 50) },
+			{ "p90", getPercentile(values, 90) },
+			{ "p99", getPercentile(values, 99) },
+			{ "max", values.last() },
+			{ "buckets", buckets }
+		};
+	}
+	return map;
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2022 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CALL_SETUP_TIMINGS_H_
+#define CALL_SETUP_TIMINGS_H_
+
+#include <QVariantMap>
+#include <QVector>
+
+// =============================================================================
+// Timestamps of the setup phases of one call, from the launch (or reception)
+// to the first received media, and rolling histograms of them across calls.
+// =============================================================================
+
+class CallSetupTimings {
+public:
+	enum Phase {
+		Launched,	// Outgoing call requested by the user.
+		AddressInterpreted,
+		Invited,	// `inviteAddressWithParams` returned.
+		IncomingReceived,
+		OutgoingProgress,
+		Ringing,
+		Connected,
+		StreamsRunning,
+		FirstRtpReceived,
+		PhaseCount
+	};
+	
+	CallSetupTimings ();
+	
+	// Only the first mark of a phase is kept.
+	void mark (Phase phase);
+	
+	bool isMarked (Phase phase) const {
+		return mTimestamps[phase] >= 0;
+	}
+	// Milliseconds since the start of the call setup. -1 if the phase was not reached.
+	qint64 getElapsed (Phase phase) const;
+	
+	// Phase name to elapsed time, for reached phases only.
+	QVariantMap toVariantMap () const;
+	QString toString () const;
+	
+	static const char *getPhaseName (Phase phase);
+	
+	// Marks done before the creation of the call model of an outgoing call.
+	static CallSetupTimings &getPending ();
+	static CallSetupTimings takePending ();
+	
+private:
+	static qint64 getTimestamp ();
+	
+	qint64 mStart = -1;
+	qint64 mTimestamps[PhaseCount];
+};
+
+// -----------------------------------------------------------------------------
+
+class CallSetupHistograms {
+public:
+	// Only the last calls are taken into account.
+	CallSetupHistograms (int window = 100);
+	
+	void add (const CallSetupTimings &timings);
+	
+	// Phase name to { count, p50, p90, p99, max, buckets: [{ le, count }] } in milliseconds.
+	QVariantMap toVariantMap () const;
+	
+private:
+	int mWindow;
+	QVector<QVector<qint64>> mValues;	// Rolling values by phase.
+	QVector<int> mNextIndexes;
+};
+
+#endif // CALL_SETUP_TIMINGS_H_
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2022 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QHash>
+#include <QPointF>
+
+#include "CallStatsHistory.hpp"
+
+// =============================================================================
+
+constexpr int CallStatsHistory::SamplingInterval;
+
+CallStatsHistory::CallStatsHistory (int capacity) {
+	setCapacity(capacity);
+}
+
+void CallStatsHistory::setCapacity (int capacity) {
+	mSamples.resize(qMax(1, capacity));
+	clear();
+}
+
+void CallStatsHistory::clear () {
+	mFirst = 0;
+	mCount = 0;
+}
+
+void CallStatsHistory::add (const Sample &sample) {
+	const int capacity = mSamples.size();
+	if (mCount > 0 && sample.timestamp - last().timestamp < SamplingInterval) {
+		mSamples[(mFirst + mCount - 1) % capacity] = sample;
+		return;
+	}
+	if (mCount < capacity)
+		mSamples[(mFirst + mCount++) % capacity] = sample;
+	else {	// Overwrite the oldest sample.
+		mSamples[mFirst] = sample;
+		mFirst = (mFirst + 1) % capacity;
+	}
+}
+
+// -----------------------------------------------------------------------------
+
+float CallStatsHistory::getValue (const Sample &sample, Field field) {
+	switch (field) {
+		case UploadBandwidth:
+			return sample.uploadBandwidth;
+		case DownloadBandwidth:
+			return sample.downloadBandwidth;
+		case EstimatedDownloadBandwidth:
+			return sample.estimatedDownloadBandwidth;
+		case SenderLossRate:
+			return sample.senderLossRate;
+		case ReceiverLossRate:
+			return sample.receiverLossRate;
+		case JitterBufferSize:
+			return sample.jitterBufferSize;
+		case ReceivedFramerate:
+			return sample.receivedFramerate;
+		case SentFramerate:
+			return sample.sentFramerate;
+	}
+	return 0;
+}
+
+bool CallStatsHistory::getField (const QString &name, Field *field) {
+	static const QHash<QString, Field> fields = {
+		{ "uploadbandwidth", UploadBandwidth },
+		{ "downloadbandwidth", DownloadBandwidth },
+		{ "estimateddownloadbandwidth", EstimatedDownloadBandwidth },
+		{ "senderlossrate", SenderLossRate },
+		{ "receiverlossrate", ReceiverLossRate },
+		{ "jitterbuffersize", JitterBufferSize },
+		{ "receivedframerate", ReceivedFramerate },
+		{ "sentframerate", SentFramerate }
+	};
+	auto it = fields.find(name.toLower());
+	if (it == fields.cend())
+		return false;
+	*field = *it;
+	return true;
+}
+
+QVariantList CallStatsHistory::getSeries (Field field) const {
+	QVariantList series;
+	series.reserve(mCount);
+	for (int i = 0; i < mCount; ++i) {
+		const Sample &sample = at(i);
+		series << QPointF(sample.timestamp, getValue(sample, field));
+	}
+	return series;
+}
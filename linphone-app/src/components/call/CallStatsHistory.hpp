@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2022 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CALL_STATS_HISTORY_H_
+#define CALL_STATS_HISTORY_H_
+
+#include <QString>
+#include <QVariantList>
+#include <QVector>
+
+// =============================================================================
+// Fixed-size ring buffer of typed stats samples of one call stream.
+// =============================================================================
+
+class CallStatsHistory {
+public:
+	struct Sample {
+		qint64 timestamp = 0;	// Milliseconds since epoch.
+		float uploadBandwidth = 0;	// kbits/s.
+		float downloadBandwidth = 0;	// kbits/s.
+		float estimatedDownloadBandwidth = 0;	// kbits/s. Video only.
+		float senderLossRate = 0;	// %.
+		float receiverLossRate = 0;	// %.
+		int jitterBufferSize = 0;	// ms. Audio only.
+		float receivedFramerate = 0;	// Video only.
+		float sentFramerate = 0;	// Video only.
+	};
+	
+	enum Field {
+		UploadBandwidth,
+		DownloadBandwidth,
+		EstimatedDownloadBandwidth,
+		SenderLossRate,
+		ReceiverLossRate,
+		JitterBufferSize,
+		ReceivedFramerate,
+		SentFramerate
+	};
+	
+	// Samples closer than this interval replace the last one.
+	static constexpr int SamplingInterval = 1000;
+	
+	CallStatsHistory (int capacity = 0);
+	
+	void setCapacity (int capacity);
+	int getCapacity () const {
+		return mSamples.size();
+	}
+	
+	void add (const Sample &sample);
+	void clear ();
+	
+	int size () const {
+		return mCount;
+	}
+	bool isEmpty () const {
+		return mCount == 0;
+	}
+	
+	// 0 is the oldest sample.
+	const Sample &at (int index) const {
+		return mSamples[(mFirst + index) % mSamples.size()];
+	}
+	const Sample &last () const {
+		return at(mCount - 1);
+	}
+	
+	static float getValue (const Sample &sample, Field field);
+	static bool getField (const QString &name, Field *field);
+	
+	// Points (x: timestamp in ms, y: value) usable by QML charts.
+	QVariantList getSeries (Field field) const;
+	
+private:
+	QVector<Sample> mSamples;
+	int mFirst = 0;
+	int mCount = 0;
+};
+
+#endif // CALL_STATS_HISTORY_H_
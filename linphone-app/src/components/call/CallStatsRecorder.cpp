@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2022 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QtDebug>
+
+#include <linphone++/linphone.hh>
+
+#include "app/paths/Paths.hpp"
+#include "utils/Utils.hpp"
+
+#include "CallStatsRecorder.hpp"
+
+// =============================================================================
+
+using namespace std;
+
+namespace {
+	constexpr quint32 RecordingMagic = 0x4C435352;	// "LCSR".
+	constexpr quint16 RecordingVersion = 1;
+	constexpr char RecordingSuffix[] = "stats";
+	
+	void setupStream (QDataStream &stream) {
+		stream.setByteOrder(QDataStream::LittleEndian);
+		stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+	}
+	
+	QString streamTypeToString (quint8 type) {
+		switch (linphone::StreamType(type)) {
+			case linphone::StreamType::Audio:
+				return QStringLiteral("audio");
+			case linphone::StreamType::Video:
+				return QStringLiteral("video");
+			case linphone::StreamType::Text:
+				return QStringLiteral("text");
+			case linphone::StreamType::Unknown:
+				break;
+		}
+		return QStringLiteral("unknown");
+	}
+	
+	QString iceStateToString (quint8 state) {
+		switch (linphone::IceState(state)) {
+			case linphone::IceState::NotActivated:
+				return QStringLiteral("notActivated");
+			case linphone::IceState::Failed:
+				return QStringLiteral("failed");
+			case linphone::IceState::InProgress:
+				return QStringLiteral("inProgress");
+			case linphone::IceState::HostConnection:
+				return QStringLiteral("hostConnection");
+			case linphone::IceState::ReflexiveConnection:
+				return QStringLiteral("reflexiveConnection");
+			case linphone::IceState::RelayConnection:
+				return QStringLiteral("relayConnection");
+		}
+		return QStringLiteral("unknown");
+	}
+	
+	QString ipFamilyToString (quint8 family) {
+		switch (linphone::AddressFamily(family)) {
+			case linphone::AddressFamily::Inet:
+				return QStringLiteral("IPv4");
+			case linphone::AddressFamily::Inet6:
+				return QStringLiteral("IPv6");
+			default:
+				break;
+		}
+		return QStringLiteral("unknown");
+	}
+}
+
+// -----------------------------------------------------------------------------
+
+CallStatsRecorder::CallStatsRecorder (const QString &filePath, const QString &peerAddress, const QString &localAddress) : mFile(filePath) {
+	if (!mFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+		qWarning() << QStringLiteral("Unable to open call stats recording: `%1`.").arg(filePath);
+		return;
+	}
+	mStartTime = QDateTime::currentMSecsSinceEpoch();
+	mStream.setDevice(&mFile);
+	setupStream(mStream);
+	mStream << RecordingMagic << RecordingVersion << mStartTime << peerAddress.toUtf8() << localAddress.toUtf8();
+	qInfo() << QStringLiteral("Recording call stats in: `%1`.").arg(filePath);
+}
+
+CallStatsRecorder::~CallStatsRecorder () {
+	close();
+}
+
+// Writes are buffered by QFile : a sample costs a few dozen bytes copied in memory.
+void CallStatsRecorder::add (const shared_ptr<const linphone::CallStats> &callStats, const QString &codec) {
+	if (!mFile.isOpen())
+		return;
+	
+	auto it = mCodecIds.find(codec);
+	if (it == mCodecIds.end()) {
+		if (mCodecIds.size() > 255)	// Ids are stored on one byte.
+			mCodecIds.clear();
+		it = mCodecIds.insert(codec, quint8(mCodecIds.size()));
+		mStream << quint8(CodecTag) << *it << codec.toUtf8();
+	}
+	
+	mStream << quint8(SampleTag)
+		<< quint32(QDateTime::currentMSecsSinceEpoch() - mStartTime)
+		<< quint8(callStats->getType())
+		<< *it
+		<< quint8(callStats->getIceState())
+		<< quint8(callStats->getIpFamilyOfRemote())
+		<< callStats->getUploadBandwidth()
+		<< callStats->getDownloadBandwidth()
+		<< callStats->getEstimatedDownloadBandwidth()
+		<< callStats->getSenderLossRate()
+		<< callStats->getReceiverLossRate()
+		<< callStats->getSenderInterarrivalJitter()
+		<< callStats->getReceiverInterarrivalJitter()
+		<< callStats->getRoundTripDelay()
+		<< qint32(callStats->getJitterBufferSizeMs());
+}
+
+void CallStatsRecorder::close () {
+	if (mFile.isOpen()) {
+		mStream.setDevice(nullptr);
+		mFile.close();
+	}
+}
+
+// -----------------------------------------------------------------------------
+
+QString CallStatsRecorder::getDirPath () {
+	return Utils::coreStringToAppString(Paths::getCallStatsDirPath());
+}
+
+QString CallStatsRecorder::findRecording (const QString &name) {
+	QDir dir(getDirPath());
+	const QFileInfoList recordings = dir.entryInfoList({ QStringLiteral("*.") + RecordingSuffix }, QDir::Files, QDir::Time);
+	if (name.isEmpty())
+		return recordings.isEmpty() ? QString() : recordings.first().absoluteFilePath();
+	
+	QFileInfo fileInfo(name);
+	if (fileInfo.isFile())
+		return fileInfo.absoluteFilePath();
+	
+	// Names may have lost their case (CLI arguments) : compare without it.
+	const QString fileName = fileInfo.fileName();
+	for (const auto &recording : recordings)
+		if (recording.fileName().compare(fileName, Qt::CaseInsensitive) == 0
+			|| recording.completeBaseName().compare(fileName, Qt::CaseInsensitive) == 0)
+			return recording.absoluteFilePath();
+	return QString();
+}
+
+bool CallStatsRecorder::decode (const QString &filePath, Recording &recording) {
+	QFile file(filePath);
+	if (!file.open(QIODevice::ReadOnly)) {
+		qWarning() << QStringLiteral("Unable to open call stats recording: `%1`.").arg(filePath);
+		return false;
+	}
+	QDataStream stream(&file);
+	setupStream(stream);
+	
+	quint32 magic;
+	quint16 version;
+	QByteArray peerAddress, localAddress;
+	stream >> magic >> version >> recording.startTime >> peerAddress >> localAddress;
+	if (stream.status() != QDataStream::Ok || magic != RecordingMagic || version != RecordingVersion) {
+		qWarning() << QStringLiteral("Invalid call stats recording: `%1`.").arg(filePath);
+		return false;
+	}
+	recording.peerAddress = QString::fromUtf8(peerAddress);
+	recording.localAddress = QString::fromUtf8(localAddress);
+	
+	QHash<quint8, QString> codecs;
+	while (!stream.atEnd()) {
+		quint8 tag;
+		stream >> tag;
+		if (tag == CodecTag) {
+			quint8 id;
+			QByteArray codec;
+			stream >> id >> codec;
+			codecs[id] = QString::fromUtf8(codec);
+		} else if (tag == SampleTag) {
+			Sample sample;
+			quint32 offset;
+			quint8 codecId;
+			stream >> offset >> sample.type >> codecId >> sample.iceState >> sample.ipFamily
+				>> sample.uploadBandwidth >> sample.downloadBandwidth >> sample.estimatedDownloadBandwidth
+				>> sample.senderLossRate >> sample.receiverLossRate
+				>> sample.senderInterarrivalJitter >> sample.receiverInterarrivalJitter
+				>> sample.roundTripDelay >> sample.jitterBufferSize;
+			if (stream.status() != QDataStream::Ok)
+				break;
+			sample.timestamp = recording.startTime + offset;
+			sample.codec = codecs.value(codecId);
+			recording.samples << sample;
+		} else {
+			qWarning() << QStringLiteral("Unknown record in call stats recording: `%1`.").arg(filePath);
+			break;
+		}
+		if (stream.status() != QDataStream::Ok)
+			break;
+	}
+	if (stream.status() != QDataStream::Ok)	// Last record was not completely written.
+		qWarning() << QStringLiteral("Truncated call stats recording: `%1`.").arg(filePath);
+	return true;
+}
+
+QString CallStatsRecorder::exportRecording (const QString &filePath, ExportFormat format) {
+	Recording recording;
+	if (!decode(filePath, recording))
+		return QString();
+	
+	QFileInfo fileInfo(filePath);
+	const QString outputPath = fileInfo.absolutePath() + "/" + fileInfo.completeBaseName() + (format == JsonFormat ? ".json" : ".csv");
+	QFile file(outputPath);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+		qWarning() << QStringLiteral("Unable to write call stats export: `%1`.").arg(outputPath);
+		return QString();
+	}
+	
+	if (format == JsonFormat) {
+		QJsonArray samples;
+		for (const auto &sample : recording.samples)
+			samples.append(QJsonObject{
+				{ "timestamp", sample.timestamp },
+				{ "stream", streamTypeToString(sample.type) },
+				{ "codec", sample.codec },
+				{ "iceState", iceStateToString(sample.iceState) },
+				{ "ipFamily", ipFamilyToString(sample.ipFamily) },
+				{ "uploadBandwidth", sample.uploadBandwidth },
+				{ "downloadBandwidth", sample.downloadBandwidth },
+				{ "estimatedDownloadBandwidth", sample.estimatedDownloadBandwidth },
+				{ "senderLossRate", sample.senderLossRate },
+				{ "receiverLossRate", sample.receiverLossRate },
+				{ "senderInterarrivalJitter", sample.senderInterarrivalJitter },
+				{ "receiverInterarrivalJitter", sample.receiverInterarrivalJitter },
+				{ "roundTripDelay", sample.roundTripDelay },
+				{ "jitterBufferSize", sample.jitterBufferSize }
+			});
+		file.write(QJsonDocument(QJsonObject{
+			{ "peerAddress", recording.peerAddress },
+			{ "localAddress", recording.localAddress },
+			{ "startTime", recording.startTime },
+			{ "samples", samples }
+		}).toJson());
+	} else {
+		QTextStream out(&file);
+		out << "timestamp,stream,codec,ice_state,ip_family,upload_bandwidth,download_bandwidth,estimated_download_bandwidth,"
+			"sender_loss_rate,receiver_loss_rate,sender_interarrival_jitter,receiver_interarrival_jitter,round_trip_delay,jitter_buffer_size\n";
+		for (const auto &sample : recording.samples)
+			out << sample.timestamp << ',' << streamTypeToString(sample.type) << ',' << sample.codec << ','
+				<< iceStateToString(sample.iceState) << ',' << ipFamilyToString(sample.ipFamily) << ','
+				<< sample.uploadBandwidth << ',' << sample.downloadBandwidth << ',' << sample.estimatedDownloadBandwidth << ','
+				<< sample.senderLossRate << ',' << sample.receiverLossRate << ','
+				<< sample.senderInterarrivalJitter << ',' << sample.receiverInterarrivalJitter << ','
+				<< sample.roundTripDelay << ',' << sample.jitterBufferSize << '\n';
+	}
+	qInfo() << QStringLiteral("Call stats exported to: `%1` (%2 samples).").arg(outputPath).arg(recording.samples.size());
+	return outputPath;
+}
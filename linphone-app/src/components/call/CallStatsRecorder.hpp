@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2022 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CALL_STATS_RECORDER_H_
+#define CALL_STATS_RECORDER_H_
+
+#include <memory>
+
+#include <QDataStream>
+#include <QFile>
+#include <QHash>
+#include <QVector>
+
+// =============================================================================
+// Append-only binary recording of the stats of one call. One file per call in
+// the call stats folder. Recordings can be exported in CSV or JSON.
+// =============================================================================
+
+namespace linphone {
+	class CallStats;
+}
+
+class CallStatsRecorder {
+public:
+	enum ExportFormat {
+		CsvFormat,
+		JsonFormat
+	};
+	
+	struct Sample {
+		qint64 timestamp = 0;	// Milliseconds since epoch.
+		quint8 type = 0;	// linphone::StreamType.
+		quint8 iceState = 0;	// linphone::IceState.
+		quint8 ipFamily = 0;	// linphone::AddressFamily.
+		QString codec;
+		float uploadBandwidth = 0;	// kbits/s.
+		float downloadBandwidth = 0;	// kbits/s.
+		float estimatedDownloadBandwidth = 0;	// kbits/s.
+		float senderLossRate = 0;	// %.
+		float receiverLossRate = 0;	// %.
+		float senderInterarrivalJitter = 0;	// ms.
+		float receiverInterarrivalJitter = 0;	// ms.
+		float roundTripDelay = 0;	// s.
+		qint32 jitterBufferSize = 0;	// ms.
+	};
+	
+	struct Recording {
+		QString peerAddress;
+		QString localAddress;
+		qint64 startTime = 0;	// Milliseconds since epoch.
+		QVector<Sample> samples;
+	};
+	
+	CallStatsRecorder (const QString &filePath, const QString &peerAddress, const QString &localAddress);
+	~CallStatsRecorder ();
+	
+	bool isOpen () const {
+		return mFile.isOpen();
+	}
+	QString getFilePath () const {
+		return mFile.fileName();
+	}
+	
+	void add (const std::shared_ptr<const linphone::CallStats> &callStats, const QString &codec);
+	void close ();
+	
+	static QString getDirPath ();
+	// Find a recording by its path or by its name in the call stats folder. Empty name gives the last recording.
+	static QString findRecording (const QString &name);
+	
+	static bool decode (const QString &filePath, Recording &recording);
+	// Export a recording next to it with the format extension. Return the output path or an empty string on error.
+	static QString exportRecording (const QString &filePath, ExportFormat format);
+	
+private:
+	enum RecordTag : quint8 {
+		CodecTag = 1,
+		SampleTag = 2
+	};
+	
+	QFile mFile;
+	QDataStream mStream;
+	qint64 mStartTime = 0;
+	QHash<QString, quint8> mCodecIds;
+};
+
+#endif // CALL_STATS_RECORDER_H_
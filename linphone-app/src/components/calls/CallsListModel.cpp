@@ -23,6 +23,7 @@
 #include <QTimer>
 
 #include "app/App.hpp"
+#include "app/tracer/Tracer.hpp"
 #include "components/call/CallModel.hpp"
 #include "components/conference/ConferenceAddModel.hpp"
 #include "components/conference/ConferenceHelperModel.hpp"
@@ -66,6 +67,7 @@ static inline int findCallIndex (QList<QSharedPointer<QObject>> &list, const Cal
 // -----------------------------------------------------------------------------
 
 CallsListModel::CallsListModel (QObject *parent) : ProxyListModel(parent) {
+	Tracer::Span span("CallsListModel::CallsListModel");
 	mCoreHandlers = CoreManager::getInstance()->getHandlers();
 	QObject::connect(
 				mCoreHandlers.get(), &CoreHandlers::callStateChanged,
@@ -93,13 +95,26 @@ void CallsListModel::askForAttendedTransfer (CallModel *callModel) {
 
 // -----------------------------------------------------------------------------
 
+// The call model is created during the invite : give it the setup timings of the launch.
+static shared_ptr<linphone::Call> inviteWithSetupTimings (const shared_ptr<linphone::Core> &core, const shared_ptr<linphone::Address> &address, const shared_ptr<linphone::CallParams> &params, const CallSetupTimings &setupTimings) {
+	CallSetupTimings::getPending() = setupTimings;
+	shared_ptr<linphone::Call> call = core->inviteAddressWithParams(address, params);
+	CallSetupTimings::takePending();	// Drop them if no call was created.
+	if (call && call->dataExists("call-model"))
+		call->getData<CallModel>("call-model").markSetupPhase(CallSetupTimings::Invited);
+	return call;
+}
+
 void CallsListModel::launchAudioCall (const QString &sipAddress, const QString& prepareTransfertAddress, const QHash<QString, QString> &headers) const {
 	CoreManager::getInstance()->getTimelineListModel()->mAutoSelectAfterCreation = true;
 	shared_ptr<linphone::Core> core = CoreManager::getInstance()->getCore();
+	CallSetupTimings setupTimings;
+	setupTimings.mark(CallSetupTimings::Launched);
 	
 	shared_ptr<linphone::Address> address = core->interpretUrl(Utils::appStringToCoreString(sipAddress));
 	if (!address)
 		return;
+	setupTimings.mark(CallSetupTimings::AddressInterpreted);
 	
 	shared_ptr<linphone::CallParams> params = core->createCallParams(nullptr);
 	params->enableVideo(false);
@@ -114,29 +129,32 @@ void CallsListModel::launchAudioCall (const QString &sipAddress, const QString&
 	shared_ptr<linphone::Account> currentAccount = core->getDefaultAccount();
 	if(currentAccount){
 		if(!CoreManager::getInstance()->getSettingsModel()->getWaitRegistrationForCall() || currentAccount->getState() == linphone::RegistrationState::Ok)
-			CallModel::prepareTransfert(core->inviteAddressWithParams(address, params), prepareTransfertAddress);
+			CallModel::prepareTransfert(inviteWithSetupTimings(core, address, params, setupTimings), prepareTransfertAddress);
 		else{
 			QObject * context = new QObject();
 			QObject::connect(CoreManager::getInstance()->getHandlers().get(), &CoreHandlers::registrationStateChanged,context,
-							 [address,core,params,currentAccount,prepareTransfertAddress, context](const std::shared_ptr<linphone::Account> &account, linphone::RegistrationState state) mutable {
+							 [address,core,params,currentAccount,prepareTransfertAddress, context, setupTimings](const std::shared_ptr<linphone::Account> &account, linphone::RegistrationState state) mutable {
 				if(context && account==currentAccount && state==linphone::RegistrationState::Ok){
-					CallModel::prepareTransfert(core->inviteAddressWithParams(address, params), prepareTransfertAddress);
+					CallModel::prepareTransfert(inviteWithSetupTimings(core, address, params, setupTimings), prepareTransfertAddress);
 					context->deleteLater();
 					context = nullptr;
 				}
 			});
 		}
 	}else
-		CallModel::prepareTransfert(core->inviteAddressWithParams(address, params), prepareTransfertAddress);
+		CallModel::prepareTransfert(inviteWithSetupTimings(core, address, params, setupTimings), prepareTransfertAddress);
 }
 
 void CallsListModel::launchSecureAudioCall (const QString &sipAddress, LinphoneEnums::MediaEncryption encryption, const QHash<QString, QString> &headers, const QString& prepareTransfertAddress) const {
 	CoreManager::getInstance()->getTimelineListModel()->mAutoSelectAfterCreation = true;
 	shared_ptr<linphone::Core> core = CoreManager::getInstance()->getCore();
+	CallSetupTimings setupTimings;
+	setupTimings.mark(CallSetupTimings::Launched);
 	
 	shared_ptr<linphone::Address> address = core->interpretUrl(Utils::appStringToCoreString(sipAddress));
 	if (!address)
 		return;
+	setupTimings.mark(CallSetupTimings::AddressInterpreted);
 	
 	shared_ptr<linphone::CallParams> params = core->createCallParams(nullptr);
 	params->enableVideo(false);
@@ -152,25 +170,27 @@ void CallsListModel::launchSecureAudioCall (const QString &sipAddress, LinphoneE
 	params->setMediaEncryption(LinphoneEnums::toLinphone(encryption));
 	if(currentAccount){
 		if(!CoreManager::getInstance()->getSettingsModel()->getWaitRegistrationForCall() || currentAccount->getState() == linphone::RegistrationState::Ok)
-			CallModel::prepareTransfert(core->inviteAddressWithParams(address, params), prepareTransfertAddress);
+			CallModel::prepareTransfert(inviteWithSetupTimings(core, address, params, setupTimings), prepareTransfertAddress);
 		else{
 			QObject * context = new QObject();
 			QObject::connect(CoreManager::getInstance()->getHandlers().get(), &CoreHandlers::registrationStateChanged,context,
-							 [address,core,params,currentAccount,prepareTransfertAddress, context](const std::shared_ptr<linphone::Account> &account, linphone::RegistrationState state) mutable {
+							 [address,core,params,currentAccount,prepareTransfertAddress, context, setupTimings](const std::shared_ptr<linphone::Account> &account, linphone::RegistrationState state) mutable {
 				if(context && account==currentAccount && state==linphone::RegistrationState::Ok){
-					CallModel::prepareTransfert(core->inviteAddressWithParams(address, params), prepareTransfertAddress);
+					CallModel::prepareTransfert(inviteWithSetupTimings(core, address, params, setupTimings), prepareTransfertAddress);
 					context->deleteLater();
 					context = nullptr;
 				}
 			});
 		}
 	}else
-		CallModel::prepareTransfert(core->inviteAddressWithParams(address, params), prepareTransfertAddress);
+		CallModel::prepareTransfert(inviteWithSetupTimings(core, address, params, setupTimings), prepareTransfertAddress);
 }
 
 void CallsListModel::launchVideoCall (const QString &sipAddress, const QString& prepareTransfertAddress, const bool& autoSelectAfterCreation, QVariantMap options) const {
 	CoreManager::getInstance()->getTimelineListModel()->mAutoSelectAfterCreation = autoSelectAfterCreation;
 	shared_ptr<linphone::Core> core = CoreManager::getInstance()->getCore();
+	CallSetupTimings setupTimings;
+	setupTimings.mark(CallSetupTimings::Launched);
 	if (!core->videoSupported()) {
 		qWarning() << QStringLiteral("Unable to launch video call. (Video not supported.) Launching audio call...");
 		launchAudioCall(sipAddress, prepareTransfertAddress, {});
@@ -180,6 +200,7 @@ void CallsListModel::launchVideoCall (const QString &sipAddress, const QString&
 	shared_ptr<linphone::Address> address = core->interpretUrl(Utils::appStringToCoreString(sipAddress));
 	if (!address)
 		return;
+	setupTimings.mark(CallSetupTimings::AddressInterpreted);
 	
 	shared_ptr<linphone::CallParams> params = core->createCallParams(nullptr);
 	
@@ -196,7 +217,7 @@ void CallsListModel::launchVideoCall (const QString &sipAddress, const QString&
 	params->setAccount(core->getDefaultAccount());
 	CallModel::setRecordFile(params, Utils::coreStringToAppString(address->getUsername()));
 	
-	auto call = core->inviteAddressWithParams(address, params);
+	auto call = inviteWithSetupTimings(core, address, params, setupTimings);
 	call->setSpeakerMuted(!enableSpeaker);
 	qInfo() << "Launch " << (enableVideo ? "video" : "audio") << " call; camera: " << enableCamera<< " speaker:" << enableSpeaker << ", micro:" << params->micEnabled() << ", layout:" << (int)layout;
 	CallModel::prepareTransfert(call, prepareTransfertAddress);
@@ -444,6 +465,12 @@ static void joinConference (const shared_ptr<linphone::Call> &call) {
 	addModel->update();
 }
 
+QVariantMap CallsListModel::getCallSetupHistograms () const {
+	return mSetupHistograms.toVariantMap();
+}
+
+// -----------------------------------------------------------------------------
+
 void CallsListModel::handleCallStateChanged (const shared_ptr<linphone::Call> &call, linphone::Call::State state) {
 	switch (state) {
 		case linphone::Call::State::IncomingReceived:
@@ -460,6 +487,7 @@ void CallsListModel::handleCallStateChanged (const shared_ptr<linphone::Call> &c
 			if(call->dataExists("call-model")) {
 				CallModel * model = &call->getData<CallModel>("call-model");
 				model->callEnded();
+				mSetupHistograms.add(model->getSetupTimings());
 			}
 			removeCall(call);
 		} break;
@@ -60,6 +60,9 @@ public:
 	
 	Q_INVOKABLE int getRunningCallsNumber () const;
 	
+	// Rolling histograms of the setup phases of the last calls.
+	Q_INVOKABLE QVariantMap getCallSetupHistograms () const;
+	
 	Q_INVOKABLE void terminateAllCalls () const;
 	Q_INVOKABLE void terminateCall (const QString& sipAddress) const;
 	
@@ -84,6 +87,7 @@ private:
 	void removeCallCb (CallModel *callModel);
 	
 	std::shared_ptr<CoreHandlers> mCoreHandlers;
+	CallSetupHistograms mSetupHistograms;
 };
 
 #endif // CALLS_LIST_MODEL_H_
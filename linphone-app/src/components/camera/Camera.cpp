@@ -29,6 +29,7 @@
 
 #include "Camera.hpp"
 #include "CameraDummy.hpp"
+#include "CameraPreviewItem.hpp"
 
 // =============================================================================
 
@@ -38,8 +39,10 @@ namespace {
 constexpr int MaxFps = 30;
 }
 
-QMutex Camera::mPreviewCounterMutex;
-int Camera::mPreviewCounter;
+QMutex Camera::mPreviewItemsMutex;
+QList<Camera *> Camera::mPreviewItems;
+Camera *Camera::mPreviewProducer = nullptr;
+int Camera::mPreviewConsumersCount = 0;
 
 // =============================================================================
 Camera::Camera (QQuickItem *parent) : QQuickFramebufferObject(parent) {
@@ -48,16 +51,20 @@ Camera::Camera (QQuickItem *parent) : QQuickFramebufferObject(parent) {
 	// The fbo content must be y-mirrored because the ms rendering is y-inverted.
 	setMirrorVertically(true);
 	
+	mMaxFps = MaxFps;
 	mRefreshTimer = new QTimer(this);
 	mRefreshTimer->setInterval(1000 / MaxFps);
 	
 	QObject::connect(
 				mRefreshTimer, &QTimer::timeout,
-				this, &QQuickFramebufferObject::update,
+				this, &Camera::handleRefreshTimeout,
 				Qt::QueuedConnection
 				);
-	
-	mRefreshTimer->start();
+	QObject::connect(this, &QQuickItem::visibleChanged, this, &Camera::updateRefreshTimer);
+	QObject::connect(this, &QQuickItem::widthChanged, this, &Camera::updateRefreshTimer);
+	QObject::connect(this, &QQuickItem::heightChanged, this, &Camera::updateRefreshTimer);
+	QObject::connect(this, &QQuickItem::windowChanged, this, &Camera::handleWindowChanged);
+	handleWindowChanged(window());
 }
 
 Camera::~Camera(){
@@ -136,6 +143,87 @@ void Camera::removeParticipantDeviceModel(){
 	mParticipantDeviceModel = nullptr;
 }
 
+// -----------------------------------------------------------------------------
+
+bool Camera::canBeSeen () const {
+	if (mMaxFps <= 0 || !isVisible() || width() <= 0 || height() <= 0)
+		return false;
+	QQuickWindow *quickWindow = window();
+	if (!quickWindow || !quickWindow->isVisible() || quickWindow->visibility() == QWindow::Minimized)
+		return false;
+	if (mCallModel && mCallModel->getStatus() == CallModel::CallStatusPaused)
+		return false;
+	return true;
+}
+
+// Remote video is repainted at the decoded frame rate : repaints above it only render the same frame.
+int Camera::getRefreshFps () const {
+	if (!mIsPreview && mCallModel && !mCallModel->getVideoStatsHistory().isEmpty()) {
+		const float receivedFramerate = mCallModel->getVideoStatsHistory().last().receivedFramerate;
+		if (receivedFramerate > 0)
+			return qBound(1, int(receivedFramerate + 0.5f), mMaxFps);
+	}
+	return mMaxFps;
+}
+
+void Camera::updateRefreshTimer () {
+	if (mIsPreview)
+		updatePreviewProducer();
+	if (!canBeSeen()) {
+		mRefreshTimer->stop();
+		return;
+	}
+	const int interval = 1000 / getRefreshFps();
+	if (mRefreshTimer->interval() != interval)
+		mRefreshTimer->setInterval(interval);
+	if (!mRefreshTimer->isActive()) {
+		mRefreshTimer->start();
+		repaint();	// Show the current frame without waiting.
+		if (mRetryRenderer)
+			retryRenderer();
+	}
+}
+
+void Camera::handleRefreshTimeout () {
+	QQuickWindow *quickWindow = window();
+	if (quickWindow && quickWindow->isExposed())	// Nothing to paint while occluded.
+		repaint();
+	updateRefreshTimer();
+}
+
+void Camera::handleWindowChanged (QQuickWindow *quickWindow) {
+	QObject::disconnect(mWindowVisibilityConnection);
+	mPreviewRenderer = nullptr;	// Deleted with the node of the previous window.
+	if (quickWindow)
+		mWindowVisibilityConnection = QObject::connect(quickWindow, &QWindow::visibilityChanged, this, &Camera::updateRefreshTimer);
+	updateRefreshTimer();
+}
+
+void Camera::repaint () {
+	if (mPreviewItem)
+		mPreviewItem->update();
+	else
+		update();
+}
+
+QSGNode *Camera::updatePaintNode (QSGNode *oldNode, UpdatePaintNodeData *data) {
+	// A consumer never creates a renderer : there is only one native preview window ID to set.
+	// A node can only exist here if this item was rendering before becoming a consumer : keep it without rendering.
+	if (mPreviewItem) {
+		if (oldNode)
+			CameraPreviewItem::removeProducerNode(oldNode);
+		return oldNode;
+	}
+	QSGNode *node = QQuickFramebufferObject::updatePaintNode(oldNode, data);
+	if (node) {// Frames are only copied while they are shown by consumers.
+		if (mIsPreview && hasPreviewConsumers())
+			CameraPreviewItem::updateProducerNode(node, window(), textureProvider());
+		else
+			CameraPreviewItem::removeProducerNode(node);
+	}
+	return node;
+}
+
 QQuickFramebufferObject::Renderer *Camera::createRenderer () const {
 	resetWindowId();
 
@@ -145,6 +233,7 @@ QQuickFramebufferObject::Renderer *Camera::createRenderer () const {
 		renderer=(QQuickFramebufferObject::Renderer *)CoreManager::getInstance()->getCore()->createNativePreviewWindowId();
 		if(renderer)
 			CoreManager::getInstance()->getCore()->setNativePreviewWindowId(renderer);
+		mPreviewRenderer = renderer;
 	}else if(mWindowIdLocation == Call){
 			auto call = mCallModel->getCall();
 			if(call){
@@ -172,9 +261,11 @@ QQuickFramebufferObject::Renderer *Camera::createRenderer () const {
 		QTimer::singleShot(1, this, &Camera::isNotReady);// Workaround for const createRenderer
 		qWarning() << "Camera stream couldn't start for Rendering. Retrying in 1s";
 		renderer = new CameraDummy();
-		QTimer::singleShot(1000, this, &Camera::requestNewRenderer);
+		mRetryRenderer = true;
+		QTimer::singleShot(1000, this, &Camera::retryRenderer);
 		
 	}else{
+		mRetryRenderer = false;
 		mIsWindowIdSet = true;
 		qDebug() << "Added " << renderer << " at " << mWindowIdLocation << " for " << this;
 		QTimer::singleShot(1, this, &Camera::isReady);// Workaround for const createRenderer
@@ -200,10 +291,18 @@ ParticipantDeviceModel * Camera::getParticipantDeviceModel() const{
 	return mParticipantDeviceModel;
 }
 
+int Camera::getMaxFps () const {
+	return mMaxFps;
+}
+
 void Camera::setCallModel (CallModel *callModel) {
 	if (mCallModel != callModel) {
+		QObject::disconnect(mCallStatusConnection);
 		mCallModel = callModel;
+		if (mCallModel)
+			mCallStatusConnection = QObject::connect(mCallModel, &CallModel::statusChanged, this, &Camera::updateRefreshTimer);
 		updateWindowIdLocation();
+		updateRefreshTimer();
 		update();
 		
 		emit callChanged(mCallModel);
@@ -224,6 +323,15 @@ void Camera::setIsPreview (bool status) {
 	}
 }
 
+void Camera::setMaxFps (int maxFps) {
+	maxFps = qBound(0, maxFps, MaxFps);
+	if (mMaxFps != maxFps) {
+		mMaxFps = maxFps;
+		updateRefreshTimer();
+		emit maxFpsChanged(mMaxFps);
+	}
+}
+
 void Camera::setIsReady(bool status) {
 	if (mIsReady != status) {
 		mIsReady = status;
@@ -236,7 +344,8 @@ if (mParticipantDeviceModel != participantDeviceModel) {
 		if( mParticipantDeviceModel)
 			disconnect(mParticipantDeviceModel, &QObject::destroyed, this, &Camera::removeParticipantDeviceModel);
 		mParticipantDeviceModel = participantDeviceModel;
-		connect(mParticipantDeviceModel, &QObject::destroyed, this, &Camera::removeParticipantDeviceModel);
+		if( mParticipantDeviceModel)
+			connect(mParticipantDeviceModel, &QObject::destroyed, this, &Camera::removeParticipantDeviceModel);
 		updateWindowIdLocation();
 		update();
 		emit participantDeviceModelChanged(mParticipantDeviceModel);
@@ -251,18 +360,119 @@ void Camera::isNotReady(){
 }
 
 void Camera::activatePreview(){
-	mPreviewCounterMutex.lock();
-	if (++mPreviewCounter == 1)
+	mPreviewItemsMutex.lock();
+	mPreviewItems << this;
+	if (mPreviewItems.size() == 1)
 		CoreManager::getInstance()->getCore()->enableVideoPreview(true);
-	mPreviewCounterMutex.unlock();
+	if (!mPreviewProducer)
+		mPreviewProducer = this;
+	mPreviewItemsMutex.unlock();
+	updatePreviewConsumer();
 }
 
 void Camera::deactivatePreview(){
+	Camera *producer = nullptr;
+	bool wasProducer = false;
+	mPreviewItemsMutex.lock();
+	mPreviewItems.removeOne(this);
 	auto core = CoreManager::getInstance()->getCore();
-	if(core){
-		mPreviewCounterMutex.lock();
-		if (--mPreviewCounter == 0)
-			core->enableVideoPreview(false);
-		mPreviewCounterMutex.unlock();
+	if (core && mPreviewItems.isEmpty())
+		core->enableVideoPreview(false);
+	if (mPreviewProducer == this) {
+		wasProducer = true;
+		// Elect a new producer, if possible one that can be seen.
+		mPreviewProducer = nullptr;
+		for (Camera *item : mPreviewItems)
+			if (!mPreviewProducer || (item->canBeSeen() && !mPreviewProducer->canBeSeen()))
+				mPreviewProducer = item;
+		producer = mPreviewProducer;
+	}
+	mPreviewItemsMutex.unlock();
+	if (wasProducer) {
+		resetWindowId();	// Before the new producer sets its own.
+		CameraPreviewItem::clearFrames();
+	}
+	if (producer)
+		producer->updatePreviewConsumer();
+	setIsPreviewConsumer(false);
+}
+
+bool Camera::isPreviewProducer () const {
+	QMutexLocker locker(&mPreviewItemsMutex);
+	return mPreviewProducer == this;
+}
+
+bool Camera::hasPreviewConsumers () const {
+	QMutexLocker locker(&mPreviewItemsMutex);
+	return mPreviewProducer == this && mPreviewConsumersCount > 0;
+}
+
+void Camera::setIsPreviewConsumer (bool isConsumer) {
+	if (isConsumer == bool(mPreviewItem))
+		return;
+	Camera *producer = nullptr;
+	{
+		QMutexLocker locker(&mPreviewItemsMutex);
+		mPreviewConsumersCount += isConsumer ? 1 : -1;
+		if (isConsumer && mPreviewConsumersCount == 1)
+			producer = mPreviewProducer;// Start to copy its frames.
 	}
+	if (isConsumer)
+		mPreviewItem = new CameraPreviewItem(this);
+	else {
+		delete mPreviewItem;
+		mPreviewItem = nullptr;
+	}
+	if (producer && producer != this)
+		producer->update();
+}
+
+// A hidden producer doesn't render anymore : a preview item that can be seen takes over, without new renderers.
+void Camera::updatePreviewProducer () {
+	Camera *oldProducer = nullptr;
+	Camera *newProducer = nullptr;
+	{
+		QMutexLocker locker(&mPreviewItemsMutex);
+		if (!mPreviewProducer || mPreviewProducer->canBeSeen())
+			return;
+		if (mPreviewProducer != this)
+			newProducer = canBeSeen() ? this : nullptr;
+		else
+			for (Camera *item : mPreviewItems)
+				if (item != this && item->canBeSeen()) {
+					newProducer = item;
+					break;
+				}
+		if (!newProducer)
+			return;
+		oldProducer = mPreviewProducer;
+		mPreviewProducer = newProducer;
+	}
+	oldProducer->updatePreviewConsumer();
+	newProducer->updatePreviewConsumer();
+}
+
+void Camera::updatePreviewConsumer () {
+	const bool isConsumer = mIsPreview && !isPreviewProducer();
+	if (isConsumer && !mPreviewItem) {
+		setIsPreviewConsumer(true);
+		resetWindowId();	// Only the producer sets the native preview window ID.
+	} else if (!isConsumer && mPreviewItem) {
+		setIsPreviewConsumer(false);
+		// This item was rendering before : its renderer becomes the native preview window again.
+		if (mPreviewRenderer && !mIsWindowIdSet && mWindowIdLocation == CorePreview) {
+			CoreManager::getInstance()->getCore()->setNativePreviewWindowId(mPreviewRenderer);
+			mIsWindowIdSet = true;
+		}
+	}
+	updateRefreshTimer();
+	update();
+}
+
+// Only recreate the renderer of an item that can be seen : a hidden one retries once it is shown.
+void Camera::retryRenderer () {
+	if (!mRetryRenderer || !canBeSeen())
+		return;
+	mRetryRenderer = false;
+	emit requestNewRenderer();
 }
@@ -34,6 +34,7 @@ namespace linphone {
 }
 
 class CallModel;
+class CameraPreviewItem;
 class ParticipantDeviceModel;
 // -----------------------------------------------------------------------------
 
@@ -44,6 +45,7 @@ class Camera : public QQuickFramebufferObject {
 	Q_PROPERTY(ParticipantDeviceModel * participantDeviceModel READ getParticipantDeviceModel WRITE setParticipantDeviceModel NOTIFY participantDeviceModelChanged)
 	Q_PROPERTY(bool isPreview READ getIsPreview WRITE setIsPreview NOTIFY isPreviewChanged);
 	Q_PROPERTY(bool isReady READ getIsReady WRITE setIsReady NOTIFY isReadyChanged);
+	Q_PROPERTY(int maxFps READ getMaxFps WRITE setMaxFps NOTIFY maxFpsChanged);	// Repaint rate cap of this item. 0 to pause it.
 
 	typedef enum{
 		None = -1,
@@ -61,8 +63,12 @@ public:
 	
 	Q_INVOKABLE void resetWindowId() const;	// const to be used from createRenderer()
 	
-	static QMutex mPreviewCounterMutex;
-	static int mPreviewCounter;
+	// Only one preview item (the producer) owns the native preview window ID. Others show its frames.
+	// All of them are guarded by mPreviewItemsMutex : the producer is also read from render threads.
+	static QMutex mPreviewItemsMutex;
+	static QList<Camera *> mPreviewItems;
+	static Camera *mPreviewProducer;
+	static int mPreviewConsumersCount;	// The producer only copies its frames for them.
 	
 	void isReady();
 	void isNotReady();
@@ -72,24 +78,44 @@ signals:
 	void isPreviewChanged (bool isPreview);
 	void isReadyChanged();
 	void participantDeviceModelChanged(ParticipantDeviceModel *participantDeviceModel);
+	void maxFpsChanged(int maxFps);
 	void requestNewRenderer();
 	
+protected:
+	QSGNode *updatePaintNode (QSGNode *oldNode, UpdatePaintNodeData *data) override;
+	
 private:
 	CallModel *getCallModel () const;
 	bool getIsPreview () const;
 	bool getIsReady () const;
 	ParticipantDeviceModel * getParticipantDeviceModel() const;
+	int getMaxFps () const;
 	
 	void setCallModel (CallModel *callModel);
 	void setIsPreview (bool status);
 	void setIsReady(bool status);
 	void setParticipantDeviceModel(ParticipantDeviceModel * participantDeviceModel);
 	void setWindowIdLocation(const WindowIdLocation& location);
+	void setMaxFps (int maxFps);
 	
 	void activatePreview();
 	void deactivatePreview();
 	void updateWindowIdLocation();
 	void removeParticipantDeviceModel();
+	void updatePreviewConsumer ();
+	void updatePreviewProducer ();	// Give the production to an item that can be seen.
+	bool isPreviewProducer () const;
+	bool hasPreviewConsumers () const;	// True if this item is the producer and its frames are shown elsewhere.
+	void setIsPreviewConsumer (bool isConsumer);
+	void retryRenderer ();
+	void repaint ();
+	
+	// Repaints only run while frames can be seen, at the rate of decoded frames.
+	bool canBeSeen () const;
+	int getRefreshFps () const;
+	void updateRefreshTimer ();
+	void handleRefreshTimeout ();
+	void handleWindowChanged (QQuickWindow *window);
 	
 	bool mIsPreview = false;
 	bool mIsReady = false;
@@ -98,8 +124,14 @@ private:
 
 	WindowIdLocation mWindowIdLocation = None;
 	mutable bool mIsWindowIdSet = false;
+	mutable QQuickFramebufferObject::Renderer *mPreviewRenderer = nullptr;	// Set again as native preview window ID if this item produces again.
+	mutable bool mRetryRenderer = false;
+	CameraPreviewItem *mPreviewItem = nullptr;	// Set if this item shows the frames of the preview producer.
 	
 	QTimer *mRefreshTimer = nullptr;
+	int mMaxFps;
+	QMetaObject::Connection mWindowVisibilityConnection;
+	QMetaObject::Connection mCallStatusConnection;
 };
 
 #endif // CAMERA_H_
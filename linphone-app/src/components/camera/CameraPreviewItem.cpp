@@ -0,0 +1,356 @@
+/*
+ * Copyright (c) 2022 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+
+#include <QMutex>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLTextureBlitter>
+#include <QQuickWindow>
+#include <QSGSimpleTextureNode>
+#include <QSGTextureProvider>
+#include <QVector>
+
+#include "CameraPreviewItem.hpp"
+
+// =============================================================================
+
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#endif
+#ifndef GL_TIMEOUT_IGNORED
+#define GL_TIMEOUT_IGNORED 0xFFFFFFFFFFFFFFFFull
+#endif
+
+namespace {
+	struct Frame {
+		GLuint textureId = 0;
+		QSize size;
+		GLsync writeFence = nullptr;	// Copy of the producer frame done.
+		QVector<GLsync> readFences;	// Draws of the consumers that released this frame done.
+	};
+	
+	// Fences need OpenGL 3.2 or OpenGL ES 3.0. Without them, wait for the GPU.
+	bool hasFences (QOpenGLContext *context) {
+		const QSurfaceFormat format = context->format();
+		return context->isOpenGLES()
+			? format.majorVersion() >= 3
+			: format.version() >= qMakePair(3, 2) || context->hasExtension(QByteArrayLiteral("GL_ARB_sync"));
+	}
+	
+	GLsync insertFence (QOpenGLContext *context) {
+		if (!hasFences(context)) {
+			context->functions()->glFinish();
+			return nullptr;
+		}
+		GLsync fence = context->extraFunctions()->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		context->functions()->glFlush();// The fence must reach the GPU to be seen from other contexts.
+		return fence;
+	}
+	
+	// Next commands of the current context wait for the fence (on the GPU side).
+	void waitFence (QOpenGLContext *context, GLsync fence) {
+		if (fence)
+			context->extraFunctions()->glWaitSync(fence, 0, GL_TIMEOUT_IGNORED);
+	}
+	
+	// -------------------------------------------------------------------------
+	// Frames are shared by all the render threads : GL objects are created and
+	// deleted by any thread that has a current context.
+	// -------------------------------------------------------------------------
+	
+	class FramePool {
+	public:
+		// Never deleted : GL objects can't be deleted once the contexts are gone.
+		static FramePool *getInstance () {
+			static FramePool *pool = new FramePool();
+			return pool;
+		}
+		
+		// Last frame of the producer, null if there is none.
+		std::shared_ptr<Frame> acquireLastFrame () {
+			QMutexLocker locker(&mFramesMutex);
+			return mLastFrame;
+		}
+		
+		// A frame can be written again after the draws of all consumers that used it.
+		void releaseFrame (std::shared_ptr<Frame> &frame) {
+			if (!frame)
+				return;
+			QOpenGLContext *context = QOpenGLContext::currentContext();
+			GLsync fence = context ? insertFence(context) : nullptr;
+			if (fence) {
+				QMutexLocker locker(&mFramesMutex);
+				frame->readFences << fence;
+			}
+			frame.reset();
+		}
+		
+		// Producer : a frame that no consumer uses anymore, or a new one.
+		std::shared_ptr<Frame> getFreeFrame (QOpenGLContext *context, const QSize &size) {
+			std::shared_ptr<Frame> frame;
+			QVector<GLsync> readFences;
+			{
+				QMutexLocker locker(&mFramesMutex);
+				for (int i = mFrames.size() - 1; i >= 0; --i) {
+					if (mFrames[i] == mLastFrame || mFrames[i].use_count() > 1)
+						continue;
+					if (mFrames[i]->size != size)
+						mFrames.removeAt(i);// Sent to the garbage.
+					else if (!frame) {
+						frame = mFrames[i];
+						readFences = frame->readFences;
+						frame->readFences.clear();
+					}
+				}
+				if (!frame) {
+					frame = std::shared_ptr<Frame>(new Frame(), &FramePool::recycleFrame);
+					frame->size = size;
+					mFrames << frame;
+				}
+			}
+			deleteGarbage(context);
+			
+			QOpenGLFunctions *functions = context->functions();
+			for (GLsync fence : readFences) {
+				waitFence(context, fence);
+				context->extraFunctions()->glDeleteSync(fence);
+			}
+			if (frame->writeFence) {
+				context->extraFunctions()->glDeleteSync(frame->writeFence);
+				frame->writeFence = nullptr;
+			}
+			if (!frame->textureId) {
+				functions->glGenTextures(1, &frame->textureId);
+				functions->glBindTexture(GL_TEXTURE_2D, frame->textureId);
+				functions->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+				functions->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+				functions->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+				functions->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+				functions->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size.width(), size.height(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+				functions->glBindTexture(GL_TEXTURE_2D, 0);
+			}
+			return frame;
+		}
+		
+		void publishFrame (const std::shared_ptr<Frame> &frame) {
+			QMutexLocker locker(&mFramesMutex);
+			mLastFrame = frame;
+		}
+		
+		void clear () {
+			QVector<std::shared_ptr<Frame>> frames;// Recycled out of the lock.
+			std::shared_ptr<Frame> lastFrame;
+			QMutexLocker locker(&mFramesMutex);
+			lastFrame.swap(mLastFrame);
+			frames.swap(mFrames);
+		}
+		
+		// Delete GL objects of the frames that are no longer used, with the current context.
+		void deleteGarbage (QOpenGLContext *context) {
+			QVector<Frame> garbage;
+			{
+				QMutexLocker locker(&mGarbageMutex);
+				garbage.swap(mGarbage);
+			}
+			for (const Frame &frame : garbage) {
+				if (frame.textureId)
+					context->functions()->glDeleteTextures(1, &frame.textureId);
+				if (frame.writeFence)
+					context->extraFunctions()->glDeleteSync(frame.writeFence);
+				for (GLsync fence : frame.readFences)
+					context->extraFunctions()->glDeleteSync(fence);
+			}
+		}
+		
+	private:
+		FramePool () = default;
+		
+		// Deleter of the frames : called from any thread, maybe without context.
+		static void recycleFrame (Frame *frame) {
+			FramePool *pool = getInstance();
+			QMutexLocker locker(&pool->mGarbageMutex);
+			pool->mGarbage << *frame;
+			delete frame;
+		}
+		
+		QMutex mFramesMutex;
+		QVector<std::shared_ptr<Frame>> mFrames;// A free frame is only referenced here.
+		std::shared_ptr<Frame> mLastFrame;
+		
+		QMutex mGarbageMutex;
+		QVector<Frame> mGarbage;// Not used anymore, to delete with a current context.
+	};
+	
+	// -------------------------------------------------------------------------
+	
+	// Child of the producer node : copy its texture after each render of its window.
+	class FrameWriterNode : public QSGNode {
+	public:
+		FrameWriterNode (QQuickWindow *window, QSGTextureProvider *provider) : mWindow(window), mProvider(provider) {
+			mConnection = QObject::connect(window, &QQuickWindow::afterRendering, window, [this] {
+				writeFrame();
+			}, Qt::DirectConnection);
+		}
+		
+		~FrameWriterNode () {
+			QObject::disconnect(mConnection);
+			QOpenGLContext *context = QOpenGLContext::currentContext();
+			if (!context)
+				return;
+			if (mBlitter.isCreated())
+				mBlitter.destroy();
+			if (mFramebuffer)
+				context->functions()->glDeleteFramebuffers(1, &mFramebuffer);
+		}
+		
+		bool isDirty = true;// The producer has a new frame.
+		
+	private:
+		void writeFrame () {
+			QSGTexture *texture = mProvider->texture();
+			QOpenGLContext *context = QOpenGLContext::currentContext();
+			if (!isDirty || !texture || !context || texture->textureSize().isEmpty())
+				return;
+			isDirty = false;
+			
+			const QSize size = texture->textureSize();
+			FramePool *pool = FramePool::getInstance();
+			std::shared_ptr<Frame> frame = pool->getFreeFrame(context, size);
+			
+			QOpenGLFunctions *functions = context->functions();
+			if (!mFramebuffer)
+				functions->glGenFramebuffers(1, &mFramebuffer);
+			functions->glBindFramebuffer(GL_FRAMEBUFFER, mFramebuffer);
+			functions->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, frame->textureId, 0);
+			functions->glViewport(0, 0, size.width(), size.height());
+			functions->glDisable(GL_BLEND);
+			functions->glDisable(GL_SCISSOR_TEST);
+			if (!mBlitter.isCreated())
+				mBlitter.create();
+			mBlitter.bind();
+			mBlitter.blit(
+				texture->textureId(),
+				QOpenGLTextureBlitter::targetTransform(QRectF(QPointF(), size), QRect(QPoint(), size)),
+				QOpenGLTextureBlitter::OriginBottomLeft
+			);
+			mBlitter.release();
+			functions->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+			functions->glBindFramebuffer(GL_FRAMEBUFFER, context->defaultFramebufferObject());
+			frame->writeFence = insertFence(context);
+			mWindow->resetOpenGLState();
+			
+			pool->publishFrame(frame);
+		}
+		
+		QQuickWindow *mWindow = nullptr;
+		QSGTextureProvider *mProvider = nullptr;
+		QMetaObject::Connection mConnection;
+		GLuint mFramebuffer = 0;
+		QOpenGLTextureBlitter mBlitter;
+	};
+	
+	FrameWriterNode *getFrameWriterNode (QSGNode *producerNode) {
+		for (QSGNode *node = producerNode->firstChild(); node; node = node->nextSibling())
+			if (FrameWriterNode *writerNode = dynamic_cast<FrameWriterNode *>(node))
+				return writerNode;
+		return nullptr;
+	}
+	
+	// -------------------------------------------------------------------------
+	
+	class PreviewNode : public QSGSimpleTextureNode {
+	public:
+		PreviewNode () {
+			setOwnsTexture(true);// Only the QSGTexture wrapper : the GL texture belongs to the frame.
+			// The ms rendering is y-inverted.
+			setTextureCoordinatesTransform(QSGSimpleTextureNode::MirrorVertically);
+		}
+		
+		~PreviewNode () {
+			FramePool::getInstance()->releaseFrame(frame);
+		}
+		
+		std::shared_ptr<Frame> frame;
+	};
+}
+
+// -----------------------------------------------------------------------------
+
+CameraPreviewItem::CameraPreviewItem (QQuickItem *parent) : QQuickItem(parent) {
+	setFlag(ItemHasContents);
+	QObject::connect(parent, &QQuickItem::widthChanged, this, &CameraPreviewItem::updateSize);
+	QObject::connect(parent, &QQuickItem::heightChanged, this, &CameraPreviewItem::updateSize);
+	updateSize();
+}
+
+void CameraPreviewItem::updateProducerNode (QSGNode *producerNode, QQuickWindow *window, QSGTextureProvider *provider) {
+	FrameWriterNode *writerNode = getFrameWriterNode(producerNode);
+	if (!writerNode) {
+		writerNode = new FrameWriterNode(window, provider);
+		producerNode->appendChildNode(writerNode);
+	}
+	writerNode->isDirty = true;
+}
+
+void CameraPreviewItem::removeProducerNode (QSGNode *producerNode) {
+	FrameWriterNode *writerNode = getFrameWriterNode(producerNode);
+	if (writerNode) {
+		producerNode->removeChildNode(writerNode);
+		delete writerNode;
+	}
+}
+
+void CameraPreviewItem::clearFrames () {
+	FramePool::getInstance()->clear();
+}
+
+void CameraPreviewItem::updateSize () {
+	setSize(parentItem()->size());
+}
+
+QSGNode *CameraPreviewItem::updatePaintNode (QSGNode *oldNode, UpdatePaintNodeData *) {
+	QOpenGLContext *context = QOpenGLContext::currentContext();
+	PreviewNode *node = static_cast<PreviewNode *>(oldNode);
+	FramePool *pool = FramePool::getInstance();
+	std::shared_ptr<Frame> frame;
+	if (context) {
+		frame = pool->acquireLastFrame();
+		pool->deleteGarbage(context);
+	}
+	if (!frame || width() <= 0 || height() <= 0) {
+		delete node;
+		return nullptr;
+	}
+	if (!node)
+		node = new PreviewNode();
+	if (node->frame != frame) {
+		pool->releaseFrame(node->frame);
+		waitFence(context, frame->writeFence);
+		node->frame = frame;
+		node->setTexture(window()->createTextureFromId(frame->textureId, frame->size));
+	}
+	// Keep the aspect ratio of the producer.
+	QSizeF size = QSizeF(frame->size).scaled(width(), height(), Qt::KeepAspectRatio);
+	node->setRect(QRectF((width() - size.width()) / 2, (height() - size.height()) / 2, size.width(), size.height()));
+	node->markDirty(QSGNode::DirtyMaterial);
+	return node;
+}
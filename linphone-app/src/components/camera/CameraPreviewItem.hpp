@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2022 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CAMERA_PREVIEW_ITEM_H_
+#define CAMERA_PREVIEW_ITEM_H_
+
+#include <QQuickItem>
+
+// =============================================================================
+// Shows the frames of the preview producer (the only Camera that owns the
+// native preview window ID). While consumers exist, the producer copies each
+// rendered frame into a texture of the shared OpenGL contexts, followed by a
+// fence.
+// Consumers wait on this fence and keep the texture while they show it: it is
+// only written again or deleted once no consumer uses it.
+// =============================================================================
+
+class QSGTextureProvider;
+
+class CameraPreviewItem : public QQuickItem {
+	Q_OBJECT
+	
+public:
+	CameraPreviewItem (QQuickItem *parent);
+	
+	// Render thread of the producer. Copy the frames of `provider` after each render of `window`.
+	static void updateProducerNode (QSGNode *producerNode, QQuickWindow *window, QSGTextureProvider *provider);
+	static void removeProducerNode (QSGNode *producerNode);
+	// No producer anymore : consumers stop showing its last frame.
+	static void clearFrames ();
+	
+protected:
+	QSGNode *updatePaintNode (QSGNode *oldNode, UpdatePaintNodeData *data) override;
+	
+private:
+	void updateSize ();
+};
+
+#endif // CAMERA_PREVIEW_ITEM_H_
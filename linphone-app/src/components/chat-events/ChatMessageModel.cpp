@@ -47,7 +47,9 @@
 #include "app/providers/ThumbnailProvider.hpp"
 #include "components/notifier/Notifier.hpp"
 #include "components/participant-imdn/ParticipantImdnStateListModel.hpp"
+#include "components/participant-imdn/ParticipantImdnStateModel.hpp"
 #include "components/participant-imdn/ParticipantImdnStateProxyModel.hpp"
+#include "components/search/MessageSearchIndex.hpp"
 #include "components/settings/AccountSettingsModel.hpp"
 #include "components/settings/SettingsModel.hpp"
 #include "utils/QExifImageHeader.hpp"
@@ -64,7 +66,20 @@ void ChatMessageModel::connectTo(ChatMessageListener * listener){
 	connect(listener, &ChatMessageListener::participantImdnStateChanged, this, &ChatMessageModel::onParticipantImdnStateChanged);
 	connect(listener, &ChatMessageListener::ephemeralMessageTimerStarted, this, &ChatMessageModel::onEphemeralMessageTimerStarted);
 	connect(listener, &ChatMessageListener::ephemeralMessageDeleted, this, &ChatMessageModel::onEphemeralMessageDeleted);
-	connect(listener, &ChatMessageListener::participantImdnStateChanged, this->getParticipantImdnStates().get(), &ParticipantImdnStateListModel::onParticipantImdnStateChanged);
+}
+
+void ChatMessageModel::addListener(){
+	if(mChatMessage && !mChatMessageListener){
+		mChatMessageListener = std::make_shared<ChatMessageListener>(parent());
+		connectTo(mChatMessageListener.get());
+		mChatMessage->addListener(mChatMessageListener);
+	}
+}
+
+// Listen only to messages that can still change by themselves. Others get a listener when their sub-models are used.
+bool ChatMessageModel::needsListener() const{
+	auto state = mChatMessage->getState();
+	return mChatMessage->isEphemeral() || state != linphone::ChatMessage::State::Displayed;
 }
 // =============================================================================
 
@@ -90,33 +105,16 @@ QString ChatMessageModel::AppDataManager::toString(){
 ChatMessageModel::ChatMessageModel ( std::shared_ptr<linphone::ChatMessage> chatMessage, QObject * parent) : ChatEvent(ChatRoomModel::EntryType::MessageEntry, parent) {
 	App::getInstance()->getEngine()->setObjectOwnership(this, QQmlEngine::CppOwnership);// Avoid QML to destroy it
 	if(chatMessage){
-		mParticipantImdnStateListModel = QSharedPointer<ParticipantImdnStateListModel>::create(chatMessage);
-		mChatMessageListener = std::make_shared<ChatMessageListener>(parent);
-		connectTo(mChatMessageListener.get());
 		mChatMessage = chatMessage;
-		mChatMessage->addListener(mChatMessageListener);
-		if( mChatMessage->isReply()){
-			auto replyMessage = mChatMessage->getReplyMessage();
-			if( replyMessage)// Reply message could be inexistant (for example : when locally deleted)
-				mReplyChatMessageModel = create(replyMessage, parent);
-		}
-		std::list<std::shared_ptr<linphone::Content>> contents = chatMessage->getContents();
-		QString txt;
-		for(auto content : contents){
-			if(content->isText())
-				txt += content->getUtf8Text().c_str();
-		}
-		mContent = txt;
-		
+		if(needsListener())
+			addListener();
 		mTimestamp = QDateTime::fromMSecsSinceEpoch(chatMessage->getTime() * 1000);
 	}
 	mWasDownloaded = false;
-
-	mContentListModel = QSharedPointer<ContentListModel>::create(this);
 }
 
 ChatMessageModel::~ChatMessageModel(){
-	if(mChatMessage)
+	if(mChatMessage && mChatMessageListener)
 		mChatMessage->removeListener(mChatMessageListener);
 }
 QSharedPointer<ChatMessageModel> ChatMessageModel::create(std::shared_ptr<linphone::ChatMessage> chatMessage, QObject * parent){
@@ -129,7 +127,7 @@ std::shared_ptr<linphone::ChatMessage> ChatMessageModel::getChatMessage(){
 }
 
 QSharedPointer<ContentModel> ChatMessageModel::getContentModel(std::shared_ptr<linphone::Content> content){
-	return mContentListModel->getContentModel(content);
+	return getContents()->getContentModel(content);
 }
 
 //-----------------------------------------------------------------------------------------------------------------------
@@ -182,6 +180,17 @@ bool ChatMessageModel::isOutgoing() const{
 	return mChatMessage && mChatMessage->isOutgoing();
 }
 
+QString ChatMessageModel::getContent() const{
+	if(!mContentCreated && mChatMessage){
+		mContentCreated = true;
+		for(auto content : mChatMessage->getContents()){
+			if(content->isText())
+				mContent += content->getUtf8Text().c_str();
+		}
+	}
+	return mContent;
+}
+
 ParticipantImdnStateProxyModel * ChatMessageModel::getProxyImdnStates(){
 	ParticipantImdnStateProxyModel * proxy = new ParticipantImdnStateProxyModel();
 	proxy->setChatMessageModel(this);
@@ -189,18 +198,48 @@ ParticipantImdnStateProxyModel * ChatMessageModel::getProxyImdnStates(){
 }
 
 QSharedPointer<ParticipantImdnStateListModel> ChatMessageModel::getParticipantImdnStates() const{
+	if(!mParticipantImdnStateListModel && mChatMessage){
+		mParticipantImdnStateListModel = QSharedPointer<ParticipantImdnStateListModel>::create(mChatMessage);
+		const_cast<ChatMessageModel*>(this)->addListener();
+	}
 	return mParticipantImdnStateListModel;
 }
 
 QSharedPointer<ContentListModel> ChatMessageModel::getContents() const{
+	if(!mContentListModel){
+		mContentListModel = QSharedPointer<ContentListModel>::create(const_cast<ChatMessageModel*>(this));
+		const_cast<ChatMessageModel*>(this)->addListener();// File transfers
+	}
 	return mContentListModel;
 }
 
+qint64 ChatMessageModel::getMemoryEstimate() const{
+	qint64 memory = sizeof(ChatMessageModel) + mContent.size() * sizeof(QChar);
+	if(mChatMessageListener)
+		memory += sizeof(ChatMessageListener);
+	if(mContentListModel){
+		memory += sizeof(ContentListModel);
+		for(auto content : mContentListModel->getSharedList<ContentModel>())
+			memory += sizeof(ContentModel) + (content->getName().size() + content->getThumbnail().size()) * sizeof(QChar);
+	}
+	if(mParticipantImdnStateListModel)
+		memory += sizeof(ParticipantImdnStateListModel) + mParticipantImdnStateListModel->rowCount() * sizeof(ParticipantImdnStateModel);
+	if(mReplyChatMessageModel)
+		memory += mReplyChatMessageModel->getMemoryEstimate();
+	return memory;
+}
+
 bool ChatMessageModel::isReply() const{
 	return mChatMessage && mChatMessage->isReply();
 }
 
 ChatMessageModel * ChatMessageModel::getReplyChatMessageModel() const{
+	if(!mReplyChatMessageModelCreated && isReply()){
+		mReplyChatMessageModelCreated = true;
+		auto replyMessage = mChatMessage->getReplyMessage();
+		if( replyMessage)// Reply message could be inexistant (for example : when locally deleted)
+			mReplyChatMessageModel = create(replyMessage, parent());
+	}
 	return mReplyChatMessageModel.get();
 }
 
@@ -264,13 +303,16 @@ void ChatMessageModel::deleteEvent(){
 		}
 		mChatMessage->setAppdata("");// Remove completely Thumbnail from the message
 	}
-	if(mChatMessage)
+	if(mChatMessage) {
+		MessageSearchIndex::getInstance()->removeMessage(mChatMessage);
 		mChatMessage->getChatRoom()->deleteMessage(mChatMessage);
+	}
 }
 
 
 void ChatMessageModel::updateFileTransferInformation(){
-	mContentListModel->updateContents(this);
+	if(mContentListModel)// Else, contents will be up to date when created.
+		mContentListModel->updateContents(this);
 }
 
 void ChatMessageModel::onFileTransferRecv(const std::shared_ptr<linphone::ChatMessage> & message, const std::shared_ptr<linphone::Content> & content, const std::shared_ptr<const linphone::Buffer> & buffer){
@@ -283,7 +325,7 @@ std::shared_ptr<linphone::Buffer> ChatMessageModel::onFileTransferSend (const st
 }
 
 void ChatMessageModel::onFileTransferProgressIndication (const std::shared_ptr<linphone::ChatMessage> &message,const std::shared_ptr<linphone::Content> &content,size_t offset,size_t total) {
-	auto contentModel = mContentListModel->getContentModel(content);
+	auto contentModel = getContents()->getContentModel(content);
 	if(contentModel) {
 		contentModel->setFileOffset(offset);
 		if (total == offset && mChatMessage && !mChatMessage->isOutgoing()) {
@@ -302,7 +344,8 @@ void ChatMessageModel::onMsgStateChanged (const std::shared_ptr<linphone::ChatMe
 	emit stateChanged();
 }
 void ChatMessageModel::onParticipantImdnStateChanged(const std::shared_ptr<linphone::ChatMessage> & message, const std::shared_ptr<const linphone::ParticipantImdnState> & state){
-	
+	if(mParticipantImdnStateListModel)
+		mParticipantImdnStateListModel->onParticipantImdnStateChanged(message, state);
 }
 void ChatMessageModel::onEphemeralMessageTimerStarted(const std::shared_ptr<linphone::ChatMessage> & message) {
 	emit ephemeralExpireTimeChanged();
@@ -310,7 +353,7 @@ void ChatMessageModel::onEphemeralMessageTimerStarted(const std::shared_ptr<linp
 void ChatMessageModel::onEphemeralMessageDeleted(const std::shared_ptr<linphone::ChatMessage> & message) {
 	//emit remove(mSelf.lock());
 	if(!isOutgoing())
-		mContentListModel->removeDownloadedFiles();
+		getContents()->removeDownloadedFiles();
 	emit remove(this);
 }
 //-------------------------------------------------------------------------------------------------------
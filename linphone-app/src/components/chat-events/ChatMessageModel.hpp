@@ -83,7 +83,8 @@ public:
 	Q_PROPERTY(bool wasDownloaded MEMBER mWasDownloaded WRITE setWasDownloaded NOTIFY wasDownloadedChanged)
 	Q_PROPERTY(ChatRoomModel::EntryType type MEMBER mType CONSTANT)
 	Q_PROPERTY(QDateTime timestamp MEMBER mTimestamp CONSTANT)
-	Q_PROPERTY(QString content MEMBER mContent NOTIFY contentChanged)
+	Q_PROPERTY(QString content READ getContent NOTIFY contentChanged)
+	Q_PROPERTY(int contentHeight MEMBER mContentHeight NOTIFY contentHeightChanged)// Last height of the displayed content. Kept by its stub.
 	
 	
 	Q_PROPERTY(bool isReply READ isReply CONSTANT)
@@ -110,9 +111,11 @@ public:
 	Q_INVOKABLE long getEphemeralLifetime() const;
 	LinphoneEnums::ChatMessageState getState() const;
 	bool isOutgoing() const;
+	QString getContent() const;// Text contents
 	Q_INVOKABLE ParticipantImdnStateProxyModel * getProxyImdnStates();
 	QSharedPointer<ParticipantImdnStateListModel> getParticipantImdnStates() const;
 	QSharedPointer<ContentListModel> getContents() const;
+	qint64 getMemoryEstimate() const;// Approximate bytes used by the model and its sub-models.
 	
 	bool isReply() const;
 	ChatMessageModel * getReplyChatMessageModel() const;
@@ -144,8 +147,8 @@ public:
 	
 	//----------------------------------------------------------------------------
 	bool mWasDownloaded;
-	QString mContent;
 	QString mIsOutgoing;
+	int mContentHeight = 0;
 	//----------------------------------------------------------------------------
 	
 signals:
@@ -154,6 +157,7 @@ signals:
 	void stateChanged();
 	void wasDownloadedChanged();
 	void contentChanged();
+	void contentHeightChanged();
 	void isOutgoingChanged();
 	void fileContentChanged();
 	void remove(ChatMessageModel* model);
@@ -161,14 +165,19 @@ signals:
 	
 private:
 	void connectTo(ChatMessageListener * listener);
+	void addListener();// Sub-models and listener are built on first use : most of loaded messages are never displayed.
+	bool needsListener() const;
 
 	std::shared_ptr<linphone::ChatMessage> mChatMessage;
 	std::shared_ptr<ChatMessageListener> mChatMessageListener;	// This is passed to linpĥone object and must be in shared_ptr
 	
-	QSharedPointer<ContentListModel> mContentListModel;
+	mutable QSharedPointer<ContentListModel> mContentListModel;
 	QSharedPointer<ContentModel> mFileTransfertContent;
-	QSharedPointer<ParticipantImdnStateListModel> mParticipantImdnStateListModel;
-	QSharedPointer<ChatMessageModel> mReplyChatMessageModel;
+	mutable QSharedPointer<ParticipantImdnStateListModel> mParticipantImdnStateListModel;
+	mutable QSharedPointer<ChatMessageModel> mReplyChatMessageModel;
+	mutable bool mReplyChatMessageModelCreated = false;
+	mutable QString mContent;
+	mutable bool mContentCreated = false;
 };
 Q_DECLARE_METATYPE(ChatMessageModel*)
 Q_DECLARE_METATYPE(QSharedPointer<ChatMessageModel>)
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2022 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <QQmlApplicationEngine>
+
+#include "app/App.hpp"
+
+#include "ChatMessageModel.hpp"
+#include "ChatMessageStub.hpp"
+
+// =============================================================================
+
+ChatMessageStub::ChatMessageStub (QSharedPointer<ChatMessageModel> model, QObject * parent) : ChatEvent(ChatRoomModel::EntryType::MessageEntry, parent) {
+	App::getInstance()->getEngine()->setObjectOwnership(this, QQmlEngine::CppOwnership);// Avoid QML to destroy it when passing by Q_INVOKABLE
+	mChatMessage = model->getChatMessage();
+	mContent = model->getContent();
+	mTimestamp = model->getTimestamp();
+	mContentHeight = model->mContentHeight;
+}
+
+ChatMessageStub::~ChatMessageStub(){
+}
+
+QSharedPointer<ChatMessageStub> ChatMessageStub::create(QSharedPointer<ChatMessageModel> model, QObject * parent){
+	return QSharedPointer<ChatMessageStub>::create(model, parent);
+}
+
+std::shared_ptr<linphone::ChatMessage> ChatMessageStub::getChatMessage() const{
+	return mChatMessage;
+}
+
+bool ChatMessageStub::isStub() const{
+	return true;
+}
+
+QSharedPointer<ChatMessageModel> ChatMessageStub::rehydrate() const{
+	auto model = ChatMessageModel::create(mChatMessage);
+	if(model)
+		model->mContentHeight = mContentHeight;
+	return model;
+}
+
+void ChatMessageStub::deleteEvent(){
+	auto model = rehydrate();// Thumbnails and file transfers are managed by the model.
+	if(model)
+		model->deleteEvent();
+}
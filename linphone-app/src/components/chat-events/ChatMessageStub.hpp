@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2022 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef CHAT_MESSAGE_STUB_H
+#define CHAT_MESSAGE_STUB_H
+
+#include "ChatEvent.hpp"
+
+// =============================================================================
+// Lightweight entry that replaces a ChatMessageModel far from the view.
+// It keeps what is needed to sort, filter and rehydrate the message.
+// =============================================================================
+
+class ChatMessageModel;
+
+class ChatMessageStub : public ChatEvent {
+	Q_OBJECT
+	
+public:
+	static QSharedPointer<ChatMessageStub> create(QSharedPointer<ChatMessageModel> model, QObject * parent = nullptr);// Call it instead constructor
+	ChatMessageStub (QSharedPointer<ChatMessageModel> model, QObject * parent = nullptr);
+	virtual ~ChatMessageStub();
+	
+	Q_PROPERTY(ChatRoomModel::EntryType type MEMBER mType CONSTANT)// MessageEntry
+	Q_PROPERTY(QDateTime timestamp MEMBER mTimestamp CONSTANT)
+	Q_PROPERTY(bool isStub READ isStub CONSTANT)
+	Q_PROPERTY(int contentHeight MEMBER mContentHeight CONSTANT)// Used to keep the row height while the message is released.
+	
+	std::shared_ptr<linphone::ChatMessage> getChatMessage() const;
+	bool isStub() const;
+	
+	QSharedPointer<ChatMessageModel> rehydrate() const;
+	virtual void deleteEvent() override;
+	
+	QString mContent;	// Used by text filters
+	int mContentHeight = 0;
+	
+private:
+	std::shared_ptr<linphone::ChatMessage> mChatMessage;
+};
+
+Q_DECLARE_METATYPE(QSharedPointer<ChatMessageStub>)
+Q_DECLARE_METATYPE(ChatMessageStub*)
+
+#endif
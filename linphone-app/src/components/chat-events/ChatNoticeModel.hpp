@@ -34,7 +34,8 @@ public:
 	enum NoticeType {
 		NoticeMessage,	// This is a Linphone message
 		NoticeError,	// This is a Linphone error
-		NoticeUnreadMessages
+		NoticeUnreadMessages,
+		NoticeHistoryGap	// Entries that are not loaded between the history window and the newest entries
 	};
 	Q_ENUM(NoticeType);
 	
@@ -21,6 +21,7 @@
 #include "ChatRoomModel.hpp"
 
 #include <algorithm>
+#include <limits>
 
 #include <QDateTime>
 #include <QDesktopServices>
@@ -44,6 +45,7 @@
 #include "components/chat-events/ChatCallModel.hpp"
 #include "components/chat-events/ChatEvent.hpp"
 #include "components/chat-events/ChatMessageModel.hpp"
+#include "components/chat-events/ChatMessageStub.hpp"
 #include "components/chat-events/ChatNoticeModel.hpp"
 #include "components/contact/ContactModel.hpp"
 #include "components/contact/VcardModel.hpp"
@@ -60,6 +62,7 @@
 #include "components/presence/Presence.hpp"
 #include "components/recorder/RecorderManager.hpp"
 #include "components/recorder/RecorderModel.hpp"
+#include "components/search/MessageSearchIndex.hpp"
 #include "components/timeline/TimelineModel.hpp"
 #include "components/timeline/TimelineListModel.hpp"
 #include "components/core/event-count-notifier/AbstractEventCountNotifier.hpp"
@@ -117,6 +120,7 @@ QSharedPointer<ChatRoomModel> ChatRoomModel::create(std::shared_ptr<linphone::Ch
 
 ChatRoomModel::ChatRoomModel (std::shared_ptr<linphone::ChatRoom> chatRoom, QObject * parent) : ProxyListModel(parent){
 	App::getInstance()->getEngine()->setObjectOwnership(this, QQmlEngine::CppOwnership);// Avoid QML to destroy it when passing by Q_INVOKABLE
+	setRowIndexEnabled(true);// Entries are removed by pointer from their own signals.
 	CoreManager *coreManager = CoreManager::getInstance();
 	mCoreHandlers = coreManager->getHandlers();
 	
@@ -149,6 +153,9 @@ ChatRoomModel::ChatRoomModel (std::shared_ptr<linphone::ChatRoom> chatRoom, QObj
 	QObject::connect(coreManager->getContactsListModel(), &ContactsListModel::contactUpdated, this, &ChatRoomModel::avatarChanged);
 
 	connect(this, &ChatRoomModel::fullPeerAddressChanged, this, &ChatRoomModel::usernameChanged);
+	connect(this, &ChatRoomModel::rowsInserted, this, &ChatRoomModel::residentEntriesChanged);
+	connect(this, &ChatRoomModel::rowsRemoved, this, &ChatRoomModel::residentEntriesChanged);
+	connect(this, &ChatRoomModel::modelReset, this, &ChatRoomModel::residentEntriesChanged);
 	
 
 	//QObject::connect(this, &ChatRoomModel::messageCountReset, coreManager, &CoreManager::eventCountChanged  );
@@ -187,8 +194,10 @@ ChatRoomModel::~ChatRoomModel () {
 				for(auto p : participants)
 					participantsAddress.push_back(p->getAddress()->clone());
 				auto internalChatRoom = CoreManager::getInstance()->getCore()->searchChatRoom(mChatRoom->getCurrentParams(), mChatRoom->getLocalAddress(), mChatRoom->getPeerAddress(), participantsAddress);
-				if( internalChatRoom)
+				if( internalChatRoom) {
+					MessageSearchIndex::getInstance()->removeChatRoom(internalChatRoom);
 					CoreManager::getInstance()->getCore()->deleteChatRoom(internalChatRoom);
+				}
 			}
 		}
 	}
@@ -247,6 +256,8 @@ void ChatRoomModel::removeAllEntries () {
 	bool standardChatEnabled = CoreManager::getInstance()->getSettingsModel()->getStandardChatEnabled();
 	beginResetModel();
 	mList.clear();
+	mHistoryGap = nullptr;
+	MessageSearchIndex::getInstance()->removeChatRoom(mChatRoom);
 	mChatRoom->deleteHistory();
 	if( isOneToOne() && // Remove calls only if chat room is one-one and not secure (if available)
 		( !standardChatEnabled || !isSecure())
@@ -753,7 +764,11 @@ public:
 		itEntries = lastEntry;
 		if(itEntries - entries.begin() < 3)
 			itEntries = entries.begin();
-		for(; itEntries !=  entries.end() ; ++itEntries){
+		createEntries(resultEntries, itEntries, entries.end());
+	}
+	
+	static void createEntries(QList<QSharedPointer<ChatEvent> > *resultEntries, QList<EntrySorterHelper>::iterator itEntries, QList<EntrySorterHelper>::iterator end) {
+		for(; itEntries != end ; ++itEntries){
 			if( (*itEntries).mType== ChatRoomModel::EntryType::MessageEntry)
 				*resultEntries << ChatMessageModel::create(std::dynamic_pointer_cast<linphone::ChatMessage>(itEntries->mObject));
 			else if( (*itEntries).mType == ChatRoomModel::EntryType::CallEntry) {
@@ -805,32 +820,20 @@ int ChatRoomModel::loadTillMessage(ChatMessageModel * message){
 	if( message){
 		qDebug() << "Load history till message : " << message->getChatMessage()->getMessageId().c_str();
 		auto linphoneMessage = message->getChatMessage();
+		auto findMessage = [this, linphoneMessage](){
+			auto entry = std::find_if(mList.begin(), mList.end(), [linphoneMessage](const QSharedPointer<QObject>& entry ){
+				return getEntryChatMessage(entry) == linphoneMessage;
+			});
+			return entry == mList.end() ? -1 : int(entry - mList.begin());
+		};
 	// First find on current list
-		auto entry = std::find_if(mList.begin(), mList.end(), [linphoneMessage](const QSharedPointer<QObject>& entry ){
-			auto chatEventEntry = entry.objectCast<ChatEvent>();
-			return chatEventEntry->mType == ChatRoomModel::EntryType::MessageEntry && chatEventEntry.objectCast<ChatMessageModel>()->getChatMessage() == linphoneMessage;
-		});
-	// if not find, load more entries and find it in new entries.
-		if( entry == mList.end()){
-			int newEntries = loadMoreEntries();
-			while( newEntries > 0){// no more new entries
-				int entryCount = 0;
-				entry = mList.begin();
-				auto chatEventEntry = entry->objectCast<ChatEvent>();	
-				while(entryCount < newEntries && 
-					(chatEventEntry->mType != ChatRoomModel::EntryType::MessageEntry || chatEventEntry.objectCast<ChatMessageModel>()->getChatMessage() != linphoneMessage)
-				){
-					++entryCount;
-					++entry;
-				}
-				if( entryCount < newEntries){// We got it
-					qDebug() << "Find message at " << entryCount << " after loading new entries";
-					return entryCount;
-				}else
-					newEntries = loadMoreEntries();// continue
-			}
-		}else{
-			int entryCount = entry - mList.begin();
+		int entryCount = findMessage();
+	// if not find, load the history around it.
+		if( entryCount < 0){
+			loadHistoryWindow(linphoneMessage->getTime());
+			entryCount = findMessage();
+		}
+		if( entryCount >= 0){
 			qDebug() << "Find message at " << entryCount;
 			return entryCount;
 		}
@@ -839,9 +842,29 @@ int ChatRoomModel::loadTillMessage(ChatMessageModel * message){
 	return -1;
 }
 
+int ChatRoomModel::loadTillTime(const QDateTime& time){
+	auto findEntry = [this, time](){
+		int index = 0;
+		while( index < mList.size() && (mList[index] == mHistoryGap || mList[index].objectCast<ChatEvent>()->getTimestamp() < time))
+			++index;
+		return index < mList.size() ? index : mList.size() - 1;
+	};
+	qDebug() << "Load history till time : " << time.toString();
+// Entries around time are loaded if they are between the oldest entry and the gap.
+	int gapIndex = mHistoryGap ? indexOf(mHistoryGap.get()) : mList.size();
+	int oldestIndex = (mList.size() > 0 && mList.first() == mUnreadMessageNotice ? 1 : 0);
+	if( oldestIndex < gapIndex && mList[oldestIndex].objectCast<ChatEvent>()->getTimestamp() <= time
+		&& (!mHistoryGap || time <= mList[gapIndex - 1].objectCast<ChatEvent>()->getTimestamp()))
+		return findEntry();
+	loadHistoryWindow(time.toMSecsSinceEpoch() / 1000);
+	return findEntry();
+}
+
 void ChatRoomModel::initEntries(){
-	if( mList.size() > mLastEntriesStep)
+	if( mList.size() > mLastEntriesStep || mHistoryGap){
 		resetData();
+		mHistoryGap = nullptr;
+	}
 	if(mList.size() == 0) {
 		qDebug() << "Internal Entries : Init";
 	// On call : reinitialize all entries. This allow to free up memory
@@ -855,25 +878,15 @@ void ChatRoomModel::initEntries(){
 		for(auto &eventLog : mChatRoom->getHistoryEvents(mFirstLastEntriesStep))
 			prepareEntries << EntrySorterHelper(eventLog->getCreationTime() , NoticeEntry, eventLog);
 	// Get calls.
-		bool secureChatEnabled = CoreManager::getInstance()->getSettingsModel()->getSecureChatEnabled();
-		bool standardChatEnabled = CoreManager::getInstance()->getSettingsModel()->getStandardChatEnabled();
-	
-		if( isOneToOne() && (secureChatEnabled && !standardChatEnabled && isSecure()
-			|| standardChatEnabled && !isSecure()) ) {
-			auto callHistory = CallsListModel::getCallHistory(getParticipantAddress(), Utils::coreStringToAppString(mChatRoom->getLocalAddress()->asStringUriOnly()));
-			// callhistory is sorted from newest to oldest
-			int count = 0;
-			for (auto callLog = callHistory.begin() ; count < mFirstLastEntriesStep && callLog != callHistory.end() ; ++callLog, ++count ){
-				prepareEntries << EntrySorterHelper((*callLog)->getStartDate(), CallEntry, *callLog);
-			}
+		auto callHistory = getCallEntries();
+		int count = 0;
+		for (auto callLog = callHistory.begin() ; count < mFirstLastEntriesStep && callLog != callHistory.end() ; ++callLog, ++count ){
+			prepareEntries << EntrySorterHelper((*callLog)->getStartDate(), CallEntry, *callLog);
 		}
 		EntrySorterHelper::getLimitedSelection(&entries, prepareEntries, mFirstLastEntriesStep, this);
 		qDebug() << "Internal Entries : Built";
 		if(entries.size() >0){
-			beginInsertRows(QModelIndex(),0, entries.size()-1);
-			for(auto e : entries)
-				mList.push_back(e);
-			endInsertRows();
+			add(entries);
 			updateNewMessageNotice(mChatRoom->getUnreadMessagesCount());
 		}
 		qDebug() << "Internal Entries : End";
@@ -898,7 +911,13 @@ int ChatRoomModel::loadMoreEntries(){
 	// Get current event count for each type
 		QVector<int> entriesCounts;
 		entriesCounts.resize(3);
-		for(auto itEntries = mList.begin() ; itEntries != mList.end() ; ++itEntries){
+		if( mHistoryGap){// Loaded entries are not contiguous : get offsets from the oldest one.
+			QDateTime oldestTime = QDateTime::currentDateTime();
+			for(auto itEntries = mList.begin() ; itEntries != mList.end() ; ++itEntries)
+				if( *itEntries != mHistoryGap && *itEntries != mUnreadMessageNotice)
+					oldestTime = min(oldestTime, itEntries->objectCast<ChatEvent>()->getTimestamp());
+			entriesCounts = getHistoryOffsets(oldestTime.toMSecsSinceEpoch() / 1000);
+		}else for(auto itEntries = mList.begin() ; itEntries != mList.end() ; ++itEntries){
 			auto chatEvent = itEntries->objectCast<ChatEvent>();
 			if( chatEvent->mType == MessageEntry)
 				++entriesCounts[0];
@@ -909,26 +928,16 @@ int ChatRoomModel::loadMoreEntries(){
 				++entriesCounts[2];
 		}
 		
+		QSet<const void*> loadedEntries = getLoadedEntries();
 	// Messages
 		for (auto &message : mChatRoom->getHistoryRange(entriesCounts[0], entriesCounts[0]+mLastEntriesStep)){
-			auto itEntries = mList.begin();
-			bool haveEntry = false;
-			while(!haveEntry && itEntries != mList.end()){
-				auto entry = itEntries->objectCast<ChatMessageModel>();
-				haveEntry = (entry && entry->getChatMessage() == message);
-				++itEntries;
-			}
-			if(!haveEntry)
+			if(!loadedEntries.contains(message.get()))
 				prepareEntries << EntrySorterHelper(message->getTime() ,MessageEntry, message);
 		}
 	
 	// Calls
-		bool secureChatEnabled = CoreManager::getInstance()->getSettingsModel()->getSecureChatEnabled();
-		bool standardChatEnabled = CoreManager::getInstance()->getSettingsModel()->getStandardChatEnabled();
-	
-		if( isOneToOne() && (secureChatEnabled && !standardChatEnabled && isSecure()
-			|| standardChatEnabled && !isSecure()) ) {
-			auto callHistory = CallsListModel::getCallHistory(getParticipantAddress(), Utils::coreStringToAppString(mChatRoom->getLocalAddress()->asStringUriOnly()));
+		{
+			auto callHistory = getCallEntries();
 			int count = 0;
 			auto itCallHistory = callHistory.begin();
 			while(count < entriesCounts[1] && itCallHistory != callHistory.end()){
@@ -943,23 +952,13 @@ int ChatRoomModel::loadMoreEntries(){
 		}
 	// Notices
 		for (auto &eventLog : mChatRoom->getHistoryRangeEvents(entriesCounts[2], entriesCounts[2]+mLastEntriesStep)){
-			auto itEntries = mList.begin();
-			bool haveEntry = false;
-			while(!haveEntry && itEntries != mList.end()){
-				auto entry = itEntries->objectCast<ChatNoticeModel>();
-				haveEntry = (entry && entry->getEventLog() && entry->getEventLog() == eventLog);
-				++itEntries;
-			}
-			if(!haveEntry)
+			if(!loadedEntries.contains(eventLog.get()))
 				prepareEntries << EntrySorterHelper(eventLog->getCreationTime() , NoticeEntry, eventLog);
 		}
 		EntrySorterHelper::getLimitedSelection(&entries, prepareEntries, mLastEntriesStep, this);
 		
 		if(entries.size() >0){
-			beginInsertRows(QModelIndex(), 0, entries.size()-1);
-			for(auto entry : entries)
-				mList.prepend(entry);
-			endInsertRows();
+			prepend(entries);
 			//emit layoutChanged();
 			updateLastUpdateTime();
 		}
@@ -971,6 +970,293 @@ int ChatRoomModel::loadMoreEntries(){
 	return currentRowCount;
 }
 
+//-------------------------------------------------
+// History window
+//-------------------------------------------------
+//	Seeking an old entry doesn't load all entries till it : entries are replaced by a window of history around the anchor.
+//	Offsets of the anchor are found by a binary search on history ranges, where only one entry is retrieved at each step.
+//	Newer entries that are not loaded are represented by a gap notice (mHistoryGap). Incoming entries are still added after it.
+//	The window is paged in both directions : loadMoreEntries() toward the oldest entries, loadGapEntries() toward the gap.
+//	In a selection, each type of entries that has more entries beyond the retrieved ones limits its time range. Like that, there
+//	are no holes between selected entries of different types.
+
+namespace {
+	// Return the offset of the first entry that is not newer than time. getTime(offset) must not increase with offset.
+	template<class Getter>
+	int findHistoryOffset (int size, time_t time, Getter getTime) {
+		int begin = 0, end = size;
+		while( begin < end){
+			int middle = begin + (end - begin) / 2;
+			if( getTime(middle) > time)
+				begin = middle + 1;
+			else
+				end = middle;
+		}
+		return begin;
+	}
+}
+
+std::list<std::shared_ptr<linphone::CallLog>> ChatRoomModel::getCallEntries(){
+	bool secureChatEnabled = CoreManager::getInstance()->getSettingsModel()->getSecureChatEnabled();
+	bool standardChatEnabled = CoreManager::getInstance()->getSettingsModel()->getStandardChatEnabled();
+	
+	if( isOneToOne() && (secureChatEnabled && !standardChatEnabled && isSecure()
+		|| standardChatEnabled && !isSecure()) )
+		return CallsListModel::getCallHistory(getParticipantAddress(), Utils::coreStringToAppString(mChatRoom->getLocalAddress()->asStringUriOnly()));
+	else
+		return std::list<std::shared_ptr<linphone::CallLog>>();
+}
+
+QVector<int> ChatRoomModel::getHistoryOffsets(time_t time){
+	QVector<int> offsets(3, 0);
+	// A range can include its end : keep the newest entry.
+	offsets[0] = findHistoryOffset(mChatRoom->getHistorySize(), time, [this](int offset){
+		time_t entryTime = 0;
+		for(auto &message : mChatRoom->getHistoryRange(offset, offset + 1))
+			entryTime = max(entryTime, message->getTime());
+		return entryTime;
+	});
+	for(auto &callLog : getCallEntries()){
+		if( callLog->getStartDate() <= time)
+			break;
+		++offsets[1];
+	}
+	offsets[2] = findHistoryOffset(mChatRoom->getHistoryEventsSize(), time, [this](int offset){
+		time_t entryTime = 0;
+		for(auto &eventLog : mChatRoom->getHistoryRangeEvents(offset, offset + 1))
+			entryTime = max(entryTime, eventLog->getCreationTime());
+		return entryTime;
+	});
+	return offsets;
+}
+
+// Select not loaded entries of [offset - newerCount, offset + olderCount[ for each type. Return true if there are newer entries that are not loaded.
+QSet<const void*> ChatRoomModel::getLoadedEntries() const{
+	QSet<const void*> loadedEntries;
+	for(auto &item : mList){
+		auto chatEvent = item.objectCast<ChatEvent>();
+		if( chatEvent->mType == MessageEntry)
+			loadedEntries << getEntryChatMessage(item).get();
+		else if( chatEvent->mType == CallEntry)
+			loadedEntries << chatEvent.objectCast<ChatCallModel>()->getCallLog().get();
+		else if( chatEvent.objectCast<ChatNoticeModel>()->getEventLog())
+			loadedEntries << chatEvent.objectCast<ChatNoticeModel>()->getEventLog().get();
+	}
+	return loadedEntries;
+}
+
+bool ChatRoomModel::getHistorySelection(QList<EntrySorterHelper> *selection, const QVector<int>& offsets, int newerCount, int olderCount){
+	QSet<const void*> loadedEntries = getLoadedEntries();
+	QList<EntrySorterHelper> entries;
+	time_t newerLimit = std::numeric_limits<time_t>::max();
+	time_t olderLimit = std::numeric_limits<time_t>::min();
+	bool haveNewer = false;
+	// Add the retrieved entries of one type.
+	auto addEntries = [&](const QList<EntrySorterHelper>& typeEntries, int begin, int end, int size, bool reachLoaded){
+		if( typeEntries.isEmpty())
+			return;
+		auto bounds = std::minmax_element(typeEntries.begin(), typeEntries.end(), [](const EntrySorterHelper& a, const EntrySorterHelper& b) {
+			return a.mTime < b.mTime;
+		});
+		if( begin > 0 && !reachLoaded){
+			newerLimit = min(newerLimit, bounds.second->mTime);
+			haveNewer = true;
+		}
+		if( olderCount > 0 && end < size)
+			olderLimit = max(olderLimit, bounds.first->mTime);
+		entries << typeEntries;
+	};
+	
+	int begin, end;
+	bool reachLoaded;
+	QList<EntrySorterHelper> typeEntries;
+// Messages
+	begin = max(0, offsets[0] - newerCount);
+	end = offsets[0] + olderCount;
+	reachLoaded = false;
+	for (auto &message : mChatRoom->getHistoryRange(begin, end)){
+		if( loadedEntries.contains(message.get()))
+			reachLoaded = true;
+		else
+			typeEntries << EntrySorterHelper(message->getTime(), MessageEntry, message);
+	}
+	addEntries(typeEntries, begin, end, mChatRoom->getHistorySize(), reachLoaded);
+// Calls
+	auto callHistory = getCallEntries();
+	begin = max(0, offsets[1] - newerCount);
+	end = offsets[1] + olderCount;
+	reachLoaded = false;
+	typeEntries.clear();
+	int count = 0;
+	for(auto itCallHistory = callHistory.begin() ; count < end && itCallHistory != callHistory.end() ; ++itCallHistory, ++count){
+		if( count < begin)
+			continue;
+		if( loadedEntries.contains(itCallHistory->get()))
+			reachLoaded = true;
+		else
+			typeEntries << EntrySorterHelper((*itCallHistory)->getStartDate(), CallEntry, *itCallHistory);
+	}
+	addEntries(typeEntries, begin, end, int(callHistory.size()), reachLoaded);
+// Notices
+	begin = max(0, offsets[2] - newerCount);
+	end = offsets[2] + olderCount;
+	reachLoaded = false;
+	typeEntries.clear();
+	for (auto &eventLog : mChatRoom->getHistoryRangeEvents(begin, end)){
+		if( loadedEntries.contains(eventLog.get()))
+			reachLoaded = true;
+		else
+			typeEntries << EntrySorterHelper(eventLog->getCreationTime(), NoticeEntry, eventLog);
+	}
+	addEntries(typeEntries, begin, end, mChatRoom->getHistoryEventsSize(), reachLoaded);
+	
+	for(auto &entry : entries){
+		if( entry.mTime > newerLimit)
+			haveNewer = true;
+		else if( entry.mTime >= olderLimit)
+			*selection << entry;
+	}
+	std::sort(selection->begin(), selection->end(), [](const EntrySorterHelper& a, const EntrySorterHelper& b) {
+		return a.mTime < b.mTime;
+	});
+	return haveNewer;
+}
+
+void ChatRoomModel::setHistoryGap(int index, bool enabled){
+	if( mHistoryGap){
+		int gapIndex = indexOf(mHistoryGap.get());
+		beginRemoveRows(QModelIndex(), gapIndex, gapIndex);
+		mList.removeAt(gapIndex);
+		endRemoveRows();
+		mHistoryGap = nullptr;
+		if( gapIndex < index)
+			--index;
+	}
+	if( enabled && index > 0){// Entries are sorted by time : the gap must be just after the window.
+		QDateTime gapTime = mList[index - 1].objectCast<ChatEvent>()->getTimestamp().addMSecs(1);
+		mHistoryGap = ChatNoticeModel::create(ChatNoticeModel::NoticeType::NoticeHistoryGap, gapTime, "");
+		beginInsertRows(QModelIndex(), index, index);
+		mList.insert(index, mHistoryGap);
+		endInsertRows();
+	}
+}
+
+int ChatRoomModel::loadHistoryWindow(time_t time){
+	setEntriesLoading(true);
+	resetData();
+	mHistoryGap = nullptr;
+	mUnreadMessageNotice = nullptr;
+	QList<EntrySorterHelper> selection;
+	QList<QSharedPointer<ChatEvent> > entries;
+	bool haveNewer = getHistorySelection(&selection, getHistoryOffsets(time), mLastEntriesStep, mLastEntriesStep);
+	EntrySorterHelper::createEntries(&entries, selection.begin(), selection.end());
+	add(entries);
+	setHistoryGap(mList.size(), haveNewer);
+	qDebug() << "History window loaded with" << entries.size() << "entries" << (haveNewer ? "before a gap" : "");
+	setEntriesLoading(false);
+	return entries.size();
+}
+
+int ChatRoomModel::loadGapEntries(){
+	if( !mHistoryGap)
+		return 0;
+	setEntriesLoading(true);
+	int gapIndex = indexOf(mHistoryGap.get());
+	QDateTime windowTime = QDateTime::fromMSecsSinceEpoch(0);
+	for(int i = 0 ; i < gapIndex ; ++i)
+		if( mList[i] != mUnreadMessageNotice)
+			windowTime = max(windowTime, mList[i].objectCast<ChatEvent>()->getTimestamp());
+	QList<EntrySorterHelper> selection;
+	QList<QSharedPointer<ChatEvent> > entries;
+	bool haveNewer = getHistorySelection(&selection, getHistoryOffsets(windowTime.toMSecsSinceEpoch() / 1000), mLastEntriesStep, 0);
+	EntrySorterHelper::createEntries(&entries, selection.begin(), selection.end());
+	insert(gapIndex, toObjectList(entries));
+	setHistoryGap(gapIndex + entries.size(), haveNewer);
+	setEntriesLoading(false);
+	return entries.size();
+}
+
+//-------------------------------------------------
+// Resident entries
+//-------------------------------------------------
+//	Message models are heavy (listener, contents, IMDN states). When their estimated memory is over the limit of the settings,
+//	messages that are the farthest from the visible rows are replaced by stubs (ChatMessageStub) that keep rows, order and text filters.
+//	Stubs are rehydrated when they come near the visible rows again.
+
+std::shared_ptr<linphone::ChatMessage> ChatRoomModel::getEntryChatMessage(const QSharedPointer<QObject>& entry){
+	auto model = entry.objectCast<ChatMessageModel>();
+	if( model)
+		return model->getChatMessage();
+	auto stub = entry.objectCast<ChatMessageStub>();
+	return stub ? stub->getChatMessage() : nullptr;
+}
+
+int ChatRoomModel::getResidentEntriesCount() const{
+	int count = 0;
+	for(auto &entry : mList)
+		if( !entry.objectCast<ChatMessageStub>())
+			++count;
+	return count;
+}
+
+qint64 ChatRoomModel::getResidentEntriesMemory() const{
+	qint64 memory = 0;
+	for(auto &entry : mList){
+		auto chatEvent = entry.objectCast<ChatEvent>();
+		if( chatEvent->mType == MessageEntry){
+			auto model = chatEvent.objectCast<ChatMessageModel>();
+			memory += model ? model->getMemoryEstimate() : sizeof(ChatMessageStub);
+		}else if( chatEvent->mType == CallEntry)
+			memory += sizeof(ChatCallModel);
+		else
+			memory += sizeof(ChatNoticeModel);
+	}
+	return memory;
+}
+
+void ChatRoomModel::updateResidentEntries(int firstVisible, int lastVisible){
+	if( mList.isEmpty())
+		return;
+	int margin = max(mResidentEntriesMargin, lastVisible - firstVisible + 1);
+	int first = max(0, firstVisible - margin);
+	int last = min(mList.size() - 1, lastVisible + margin);
+	bool changed = false;
+// Rehydrate stubs near the view.
+	for(int row = first ; row <= last ; ++row){
+		auto stub = mList[row].objectCast<ChatMessageStub>();
+		if( stub){
+			auto model = stub->rehydrate();
+			if( model){
+				connect(model.get(), &ChatMessageModel::remove, this, &ChatRoomModel::removeEntry);
+				mList[row] = model;
+				emit dataChanged(index(row, 0), index(row, 0));
+				changed = true;
+			}
+		}
+	}
+// Release the farthest messages till the memory fits the limit.
+	qint64 memoryLimit = qint64(CoreManager::getInstance()->getSettingsModel()->getChatResidentMemoryLimit()) * 1024;
+	if( memoryLimit > 0){
+		qint64 memory = getResidentEntriesMemory();
+		int oldest = 0, newest = mList.size() - 1;
+		while( memory > memoryLimit && (oldest < first || newest > last)){
+			int row = (oldest < first && (newest <= last || first - oldest >= newest - last)) ? oldest++ : newest--;
+			auto model = mList[row].objectCast<ChatMessageModel>();
+			auto chatMessage = model ? model->getChatMessage() : nullptr;
+			if( !chatMessage || (mReplyModel && mReplyModel->getChatMessage() == chatMessage) || model->isEphemeral()
+				|| chatMessage->getState() == linphone::ChatMessage::State::InProgress
+				|| chatMessage->getState() == linphone::ChatMessage::State::FileTransferInProgress)
+				continue;
+			memory -= model->getMemoryEstimate() - sizeof(ChatMessageStub);
+			mList[row] = ChatMessageStub::create(model);
+			emit dataChanged(index(row, 0), index(row, 0));
+			changed = true;
+		}
+	}
+	if( changed)
+		emit residentEntriesChanged();
+}
+
 //-------------------------------------------------
 //-------------------------------------------------
 
@@ -1174,6 +1460,7 @@ void ChatRoomModel::onChatMessageReceived(const std::shared_ptr<linphone::ChatRo
 	auto message = eventLog->getChatMessage();
 	if(message){
 		insertMessageAtEnd(message);
+		MessageSearchIndex::getInstance()->addMessage(message);
 		updateLastUpdateTime();
 		emit messageReceived(message);
 	}
@@ -1183,6 +1470,7 @@ void ChatRoomModel::onChatMessageSending(const std::shared_ptr<linphone::ChatRoo
 	auto message = eventLog->getChatMessage();
 	if(message){
 		insertMessageAtEnd(message);
+		MessageSearchIndex::getInstance()->addMessage(message);
 		updateLastUpdateTime();
 		emit messageReceived(message);
 	}
@@ -1309,6 +1597,9 @@ void ChatRoomModel::onEphemeralMessageTimerStarted(const std::shared_ptr<linphon
 }
 
 void ChatRoomModel::onEphemeralMessageDeleted(const std::shared_ptr<linphone::ChatRoom> & chatRoom, const std::shared_ptr<const linphone::EventLog> & eventLog){
+	auto message = eventLog->getChatMessage();
+	if(message)// Expired messages must not be found by search anymore.
+		MessageSearchIndex::getInstance()->removeMessage(message);
 	updateLastUpdateTime();
 }
 
@@ -24,6 +24,7 @@
 #include <linphone++/linphone.hh>
 #include "app/proxyModel/ProxyListModel.hpp"
 #include <QDateTime>
+#include <QSet>
 
 // =============================================================================
 // Fetch all N messages of a ChatRoom.
@@ -38,6 +39,7 @@ class ChatRoomModel;
 class ChatMessageModel;
 class ChatNoticeModel;
 class ChatRoomListener;
+class EntrySorterHelper;
 
 class ChatRoomModel : public ProxyListModel {
 	
@@ -91,6 +93,8 @@ public:
 	Q_PROPERTY(ChatMessageModel * reply READ getReply WRITE setReply NOTIFY replyChanged)
 	
 	Q_PROPERTY(bool entriesLoading READ isEntriesLoading WRITE setEntriesLoading NOTIFY entriesLoadingChanged)
+	Q_PROPERTY(int residentEntriesCount READ getResidentEntriesCount NOTIFY residentEntriesChanged)
+	Q_PROPERTY(qint64 residentEntriesMemory READ getResidentEntriesMemory NOTIFY residentEntriesChanged)
 	
 	
 	static QSharedPointer<ChatRoomModel> create(std::shared_ptr<linphone::ChatRoom> chatRoom);
@@ -132,6 +136,8 @@ public:
 	bool canHandleParticipants() const;
 	bool getIsRemoteComposing () const;
 	bool isEntriesLoading() const;
+	int getResidentEntriesCount() const;	// Entries that are not stubs.
+	qint64 getResidentEntriesMemory() const;	// Approximate bytes used by resident entries.
 	bool isBasic() const;
 	ParticipantListModel* getParticipantListModel() const;
 	std::list<std::shared_ptr<linphone::Participant>> getParticipants() const;
@@ -172,7 +178,12 @@ public:
 	Q_INVOKABLE int loadMoreEntries();	// return new entries count
 	void callEnded(std::shared_ptr<linphone::Call> call);
 	void updateNewMessageNotice(const int& count);
-	Q_INVOKABLE int loadTillMessage(ChatMessageModel * message);// Load all entries till message and return its index. -1 if not found.
+	Q_INVOKABLE int loadTillMessage(ChatMessageModel * message);// Load entries around message and return its index. -1 if not found.
+	Q_INVOKABLE int loadTillTime(const QDateTime& time);// Load entries around time and return the index of the first entry from it. -1 if there are no entries.
+	// Load entries that follow the history window toward the newest ones. Return new entries count.
+	Q_INVOKABLE int loadGapEntries();
+	void updateResidentEntries(int firstVisible, int lastVisible);// Release entries far from the visible rows and rehydrate the near ones.
+	static std::shared_ptr<linphone::ChatMessage> getEntryChatMessage(const QSharedPointer<QObject>& entry);// From a message model or its stub.
 	
 	QDateTime mLastUpdateTime;
 	int mUnreadMessagesCount = 0;
@@ -184,6 +195,7 @@ public:
 	int mFirstLastEntriesStep = 10;	// Retrieve a part of the history to avoid too much processing at the init
 	bool mMarkAsReadEnabled = true;
 	bool mEntriesLoading = false;
+	int mResidentEntriesMargin = 50;	// Entries around the visible ones that are never released.
 	
 	
 	void insertCall (const std::shared_ptr<linphone::CallLog> &callLog);
@@ -231,6 +243,7 @@ public slots:
 signals:
 	bool isRemoteComposingChanged ();
 	void entriesLoadingChanged(const bool& loading);
+	void residentEntriesChanged();
 	void moreEntriesLoaded(const int& count);
 	
 	void allEntriesRemoved (QSharedPointer<ChatRoomModel> model);
@@ -286,6 +299,13 @@ private:
 	void handleCallCreated(const std::shared_ptr<linphone::Call> &call);// Count an event call
 	void handlePresenceStatusReceived(std::shared_ptr<linphone::Friend> contact);
 	
+	std::list<std::shared_ptr<linphone::CallLog>> getCallEntries();// Calls that are shown in this chat room, from newest to oldest.
+	QSet<const void*> getLoadedEntries() const;// Linphone objects of loaded entries : messages, call logs and event logs.
+	QVector<int> getHistoryOffsets(time_t time);// Offsets of the first message, call and notice that are not newer than time (0 is the newest).
+	bool getHistorySelection(QList<EntrySorterHelper> *selection, const QVector<int>& offsets, int newerCount, int olderCount);
+	int loadHistoryWindow(time_t time);
+	void setHistoryGap(int index, bool enabled);
+	
 	std::shared_ptr<linphone::ChatRoom> mChatRoom;
 	std::shared_ptr<ChatRoomListener> mChatRoomListener;	// This need to be a shared_ptr because of adding it to linphone
 	std::shared_ptr<CoreHandlers> mCoreHandlers;					// This need to be a shared_ptr because of adding it to linphone
@@ -295,6 +315,7 @@ private:
 	QSharedPointer<ParticipantListModel> mParticipantListModel;
 	QSharedPointer<ChatMessageModel> mReplyModel;
 	QSharedPointer<ChatNoticeModel> mUnreadMessageNotice;
+	QSharedPointer<ChatNoticeModel> mHistoryGap;	// Placeholder of the entries that are not loaded between the history window and the newest entries.
 	
 	QWeakPointer<ChatRoomModel> mSelf;
 };
@@ -18,19 +18,24 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+
 #include <QQuickWindow>
 #include <QTimer>
 
 #include "app/App.hpp"
+#include "app/tracer/ModelStats.hpp"
 #include "components/core/CoreManager.hpp"
 
 #include "ChatRoomProxyModel.hpp"
 #include "components/chat-events/ChatEvent.hpp"
 #include "components/chat-events/ChatMessageModel.hpp"
+#include "components/chat-events/ChatMessageStub.hpp"
 #include "components/chat-events/ChatNoticeModel.hpp"
 #include "components/chat-events/ChatCallModel.hpp"
 #include "components/timeline/TimelineListModel.hpp"
 #include "components/timeline/TimelineModel.hpp"
+#include "utils/Utils.hpp"
 
 // =============================================================================
 
@@ -41,6 +46,7 @@ QString ChatRoomProxyModel::gCachedText;
 // =============================================================================
 
 ChatRoomProxyModel::ChatRoomProxyModel (QObject *parent) : QSortFilterProxyModel(parent) {
+	ModelStats::watch(this);
 	mMarkAsReadEnabled = true;
 	
 	App *app = App::getInstance();
@@ -48,11 +54,12 @@ ChatRoomProxyModel::ChatRoomProxyModel (QObject *parent) : QSortFilterProxyModel
 		handleIsActiveChanged(App::getInstance()->getMainWindow());
 	});
 	
-	QQuickWindow *callsWindow = app->getCallsWindow();
+	QQuickWindow *callsWindow = app->getCallsWindowIfCreated();
 	if (callsWindow)
 		QObject::connect(callsWindow, &QWindow::activeChanged, this, [this, callsWindow]() {
 			handleIsActiveChanged(callsWindow);
 		});
+	QObject::connect(MessageSearchIndex::getInstance(), &MessageSearchIndex::searchFinished, this, &ChatRoomProxyModel::handleSearchFinished);
 	sort(0);
 }
 
@@ -80,6 +87,7 @@ ChatRoomProxyModel::ChatRoomProxyModel (QObject *parent) : QSortFilterProxyModel
 		); \
 	}
 
+CREATE_PARENT_MODEL_FUNCTION(loadGapEntries)
 CREATE_PARENT_MODEL_FUNCTION(removeAllEntries)
 
 CREATE_PARENT_MODEL_FUNCTION_WITH_PARAM(sendMessage, const QString &)
@@ -130,6 +138,7 @@ void ChatRoomProxyModel::setEntryTypeFilter (int type) {
 // -----------------------------------------------------------------------------
 
 bool ChatRoomProxyModel::filterAcceptsRow (int sourceRow, const QModelIndex &sourceParent) const {
+	ModelStats::Scope scope(this, ModelStats::FilterTiming);
 	bool show = false;
 
 	if (mEntryTypeFilter == ChatRoomModel::EntryType::GenericEntry)
@@ -140,24 +149,28 @@ bool ChatRoomProxyModel::filterAcceptsRow (int sourceRow, const QModelIndex &sou
 		
 		if( mEntryTypeFilter == ChatRoomModel::EntryType::CallEntry && eventModel.value<ChatCallModel*>() != nullptr)
 			show = true;
-		else if( mEntryTypeFilter == ChatRoomModel::EntryType::MessageEntry && eventModel.value<ChatMessageModel*>() != nullptr)
+		else if( mEntryTypeFilter == ChatRoomModel::EntryType::MessageEntry && (eventModel.value<ChatMessageModel*>() != nullptr || eventModel.value<ChatMessageStub*>() != nullptr))
 			show = true;
 		else if( mEntryTypeFilter == ChatRoomModel::EntryType::NoticeEntry && eventModel.value<ChatNoticeModel*>() != nullptr)
 			show = true;
+		else if( eventModel.value<ChatNoticeModel*>() != nullptr && eventModel.value<ChatNoticeModel*>()->mStatus == ChatNoticeModel::NoticeHistoryGap)
+			show = true;// Always show where the history is not loaded.
 	}
 	if( show && mFilterText != ""){
 		QModelIndex index = sourceModel()->index(sourceRow, 0, sourceParent);
 		auto eventModel = sourceModel()->data(index);
 		ChatMessageModel * chatModel = eventModel.value<ChatMessageModel*>();
-		if( chatModel){
-			QRegularExpression search(QRegularExpression::escape(mFilterText), QRegularExpression::CaseInsensitiveOption | QRegularExpression::UseUnicodePropertiesOption);
-			show = chatModel->mContent.contains(search);
-		}
+		ChatMessageStub * chatStub = eventModel.value<ChatMessageStub*>();
+		if( chatModel)
+			show = chatModel->getContent().contains(mFilterRegex);
+		else if( chatStub)
+			show = chatStub->mContent.contains(mFilterRegex);
 	}
 	return show;
 }
 
 bool ChatRoomProxyModel::lessThan (const QModelIndex &left, const QModelIndex &right) const {
+	ModelStats::Scope scope(this, ModelStats::SortTiming);
 	auto l = sourceModel()->data(left);
 	auto r = sourceModel()->data(right);
 	
@@ -166,11 +179,15 @@ bool ChatRoomProxyModel::lessThan (const QModelIndex &left, const QModelIndex &r
 		a = l.value<ChatNoticeModel*>();
 	if(!a)
 		a = l.value<ChatCallModel*>();
+	if(!a)
+		a = l.value<ChatMessageStub*>();
 	ChatEvent * b = r.value<ChatMessageModel*>();
 	if(!b)
 		b = r.value<ChatNoticeModel*>();
 	if(!b)
 		b = r.value<ChatCallModel*>();
+	if(!b)
+		b = r.value<ChatMessageStub*>();
 	if(!b)
 		return true;
 	if(!a)
@@ -277,6 +294,19 @@ void ChatRoomProxyModel::resetMessageCount(){
 void ChatRoomProxyModel::setFilterText(const QString& text){
 	if( mFilterText != text && mChatRoomModel){
 		mFilterText = text;
+		mFilterRegex = QRegularExpression(QRegularExpression::escape(mFilterText), QRegularExpression::CaseInsensitiveOption | QRegularExpression::UseUnicodePropertiesOption);
+		mSearchRequestId = -1;
+		mSearchResults.clear();
+		mSearchResultIndex = -1;
+		MessageSearchIndex *searchIndex = MessageSearchIndex::getInstance();
+		if( !text.isEmpty() && searchIndex->isIndexed(mChatRoomModel->getChatRoom())){
+			// Don't page the whole history : the index gives the matches, entries are loaded till the best one.
+			// While the history is not fully indexed, it is paged to not miss matches.
+			mSearchRequestId = searchIndex->search(text, mChatRoomModel->getPeerAddress(), mChatRoomModel->getLocalAddress());
+			invalidate();
+			emit filterTextChanged();
+			return;
+		}
 		int currentRowCount = rowCount();
 		int newEntries = 0;
 		do{
@@ -296,6 +326,61 @@ int ChatRoomProxyModel::loadTillMessage(ChatMessageModel * message){
 	return messageIndex;
 }
 
+void ChatRoomProxyModel::setVisibleRange (int first, int last) {
+	if( !mChatRoomModel || rowCount() == 0)
+		return;
+	first = mapToSource(index(qBound(0, first, rowCount() - 1), 0)).row();
+	last = mapToSource(index(qBound(0, last, rowCount() - 1), 0)).row();
+	mChatRoomModel->updateResidentEntries(min(first, last), max(first, last));
+}
+
+int ChatRoomProxyModel::loadTillTime(const QDateTime& time){
+	int index = mChatRoomModel->loadTillTime(time);
+	if( index >= 0)
+		index = mapFromSource(static_cast<ChatRoomModel*>(sourceModel())->index(index, 0)).row();
+	return index;
+}
+
+void ChatRoomProxyModel::handleSearchFinished (int requestId, const QVector<MessageSearchIndex::Result> &results) {
+	if( requestId != mSearchRequestId || !mChatRoomModel)
+		return;
+	mSearchRequestId = -1;
+	if( results.isEmpty())
+		return;
+// Results are ranked by relevance : keep them by time for navigation and start from the best one.
+	mSearchResults = results;
+	std::sort(mSearchResults.begin(), mSearchResults.end(), [](const MessageSearchIndex::Result &a, const MessageSearchIndex::Result &b) {
+		return a.time > b.time;
+	});
+	for(int i = 0 ; i < mSearchResults.size() ; ++i)
+		if( mSearchResults[i].messageId == results.first().messageId){
+			loadSearchMatch(i);
+			return;
+		}
+}
+
+void ChatRoomProxyModel::loadNextSearchMatch () {
+	if( mSearchResultIndex >= 0 && mSearchResultIndex < mSearchResults.size() - 1)
+		loadSearchMatch(mSearchResultIndex + 1);
+}
+
+void ChatRoomProxyModel::loadPreviousSearchMatch () {
+	if( mSearchResultIndex > 0)
+		loadSearchMatch(mSearchResultIndex - 1);
+}
+
+void ChatRoomProxyModel::loadSearchMatch (int resultIndex) {
+	if( !mChatRoomModel)
+		return;
+	mSearchResultIndex = resultIndex;
+	auto chatMessage = mChatRoomModel->getChatRoom()->findMessage(Utils::appStringToCoreString(mSearchResults[resultIndex].messageId));
+	if( chatMessage){
+		int index = loadTillMessage(ChatMessageModel::create(chatMessage).get());
+		if( index >= 0)
+			emit searchMatchLoaded(index);
+	}
+}
+
 ChatRoomModel *ChatRoomProxyModel::getChatRoomModel () const{
 	return mChatRoomModel.get();
 	
@@ -311,7 +396,7 @@ void ChatRoomProxyModel::setChatRoomModel (ChatRoomModel *chatRoomModel){
 static inline QWindow *getParentWindow (QObject *object) {
 	App *app = App::getInstance();
 	const QWindow *mainWindow = app->getMainWindow();
-	const QWindow *callsWindow = app->getCallsWindow();
+	const QWindow *callsWindow = app->getCallsWindowIfCreated();
 	for (QObject *parent = object->parent(); parent; parent = parent->parent())
 		if (parent == mainWindow || parent == callsWindow)
 			return static_cast<QWindow *>(parent);
@@ -21,9 +21,11 @@
 #ifndef CHAT_ROOM_PROXY_MODEL_H_
 #define CHAT_ROOM_PROXY_MODEL_H_
 
+#include <QRegularExpression>
 #include <QSortFilterProxyModel>
 
 #include "ChatRoomModel.hpp"
+#include "components/search/MessageSearchIndex.hpp"
 
 // =============================================================================
 
@@ -67,7 +69,12 @@ public:
 	Q_INVOKABLE void compose (const QString& text);
 	Q_INVOKABLE void resetMessageCount();
 	
-	Q_INVOKABLE int loadTillMessage(ChatMessageModel * message);// Load all entries till message and return its index in displayed list (-1 if not found)
+	Q_INVOKABLE int loadTillMessage(ChatMessageModel * message);// Load entries around message and return its index in displayed list (-1 if not found)
+	Q_INVOKABLE int loadTillTime(const QDateTime& time);// Load entries around time and return the index of the first displayed entry from it (-1 if not found)
+	Q_INVOKABLE void loadGapEntries ();
+	Q_INVOKABLE void setVisibleRange (int first, int last);// Displayed rows of the view : entries far from them can be released.
+	Q_INVOKABLE void loadNextSearchMatch ();// Older match of `filterText`.
+	Q_INVOKABLE void loadPreviousSearchMatch ();// Newer match of `filterText`.
 	
 public slots:
 	void onMoreEntriesLoaded(const int& count);
@@ -87,6 +94,7 @@ signals:
 	
 	void entryTypeFilterChanged (int type);
 	void filterTextChanged();
+	void searchMatchLoaded (int index);// A match of `filterText` in the history is loaded at this index. The best one is loaded first.
 	
 protected:
 	bool filterAcceptsRow (int sourceRow, const QModelIndex &sourceParent) const override;
@@ -122,6 +130,8 @@ private:
 	void handleIsRemoteComposingChanged ();
 	void handleMessageReceived (const std::shared_ptr<linphone::ChatMessage> &message);
 	void handleMessageSent (const std::shared_ptr<linphone::ChatMessage> &message);
+	void handleSearchFinished (int requestId, const QVector<MessageSearchIndex::Result> &results);
+	void loadSearchMatch (int resultIndex);
 	
 	int mMaxDisplayedEntries = EntriesChunkSize;
 	int mEntryTypeFilter = ChatRoomModel::EntryType::GenericEntry;
@@ -134,6 +144,10 @@ private:
 	bool mMarkAsReadEnabled;
 	
 	QString mFilterText;
+	QRegularExpression mFilterRegex;
+	int mSearchRequestId = -1;
+	QVector<MessageSearchIndex::Result> mSearchResults;// Sorted from the newest.
+	int mSearchResultIndex = -1;
 	
 	QSharedPointer<ChatRoomModel> mChatRoomModel;
 	
@@ -28,6 +28,7 @@
 #include "app/App.hpp"
 #include "app/paths/Paths.hpp"
 #include "app/providers/ThumbnailProvider.hpp"
+#include "app/tracer/Tracer.hpp"
 
 #include "components/chat-events/ChatMessageModel.hpp"
 
@@ -39,6 +40,7 @@
 // =============================================================================
 
 ChatModel::ChatModel(QObject * parent ) : QObject(parent){
+	Tracer::Span span("ChatModel::ChatModel");
 	App::getInstance()->getEngine()->setObjectOwnership(this, QQmlEngine::CppOwnership);// Avoid QML to destroy it when passing by Q_INVOKABLE
 	mContents = QSharedPointer<ContentListModel>::create(nullptr);
 }
@@ -22,6 +22,7 @@
 #include <QtDebug>
 
 #include "app/App.hpp"
+#include "app/tracer/ModelStats.hpp"
 #include "components/call/CallModel.hpp"
 #include "components/calls/CallsListModel.hpp"
 #include "components/core/CoreHandlers.hpp"
@@ -47,6 +48,7 @@ ConferenceProxyModel::ConferenceProxyModel (QObject *parent) : SortFilterProxyMo
 }
 // Show all paraticpants thar should be, will be or are still in conference
 bool ConferenceProxyModel::filterAcceptsRow (int sourceRow, const QModelIndex &sourceParent) const {
+	ModelStats::Scope scope(this, ModelStats::FilterTiming);
   const QModelIndex index = sourceModel()->index(sourceRow, 0, sourceParent);
   const CallModel *callModel = index.data().value<CallModel *>();
   return callModel->getCall()->getParams()->getLocalConferenceMode() || callModel->getCall()->getCurrentParams()->getLocalConferenceMode();
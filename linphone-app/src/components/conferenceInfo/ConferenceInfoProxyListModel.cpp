@@ -21,6 +21,7 @@
 #include "app/proxyModel/ProxyListModel.hpp"
 #include "ConferenceInfoProxyListModel.hpp"
 
+#include "app/tracer/ModelStats.hpp"
 #include "components/call/CallModel.hpp"
 #include "components/core/CoreManager.hpp"
 
@@ -39,6 +40,7 @@ ConferenceInfoProxyListModel::ConferenceInfoProxyListModel (QObject *parent) : S
 }
 
 bool ConferenceInfoProxyListModel::filterAcceptsRow (int sourceRow, const QModelIndex &sourceParent) const {
+	ModelStats::Scope scope(this, ModelStats::FilterTiming);
 	auto listModel = qobject_cast<ProxyListModel*>(sourceModel());
 	if(listModel){
 		QModelIndex index = listModel->index(sourceRow, 0, QModelIndex());
@@ -59,5 +61,6 @@ bool ConferenceInfoProxyListModel::filterAcceptsRow (int sourceRow, const QModel
 }
 
 bool ConferenceInfoProxyListModel::lessThan (const QModelIndex &left, const QModelIndex &right) const {
+	ModelStats::Scope scope(this, ModelStats::SortTiming);
 	return true;
 }
\ No newline at end of file
@@ -20,6 +20,7 @@
 
 #include "ConferenceInfoProxyModel.hpp"
 
+#include "app/tracer/ModelStats.hpp"
 #include "components/call/CallModel.hpp"
 #include "components/core/CoreManager.hpp"
 #include "components/settings/AccountSettingsModel.hpp"
@@ -48,6 +49,7 @@ void ConferenceInfoProxyModel::update(){
 }
 
 bool ConferenceInfoProxyModel::filterAcceptsRow (int sourceRow, const QModelIndex &sourceParent) const {
+	ModelStats::Scope scope(this, ModelStats::FilterTiming);
 	QModelIndex index = sourceModel()->index(sourceRow, 0, QModelIndex());
 	const ConferenceInfoMapModel* ics = sourceModel()->data(index).value<ConferenceInfoMapModel*>();
 	if(ics){
@@ -63,5 +65,6 @@ bool ConferenceInfoProxyModel::filterAcceptsRow (int sourceRow, const QModelInde
 }
 
 bool ConferenceInfoProxyModel::lessThan (const QModelIndex &left, const QModelIndex &right) const {
+	ModelStats::Scope scope(this, ModelStats::SortTiming);
 	return true;
 }
\ No newline at end of file
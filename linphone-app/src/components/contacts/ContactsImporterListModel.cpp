@@ -21,6 +21,7 @@
 #include <QQmlApplicationEngine>
 
 #include "app/App.hpp"
+#include "app/tracer/Tracer.hpp"
 #include "ContactsImporterModel.hpp"
 #include "ContactsImporterListModel.hpp"
 #include "ContactsImporterPluginsManager.hpp"
@@ -32,6 +33,7 @@
 using namespace std;
 
 ContactsImporterListModel::ContactsImporterListModel (QObject *parent) : ProxyListModel(parent) {
+  Tracer::Span span("ContactsImporterListModel::ContactsImporterListModel");
   // Init contacts with linphone friends list.
 	mMaxContactsImporterId = -1;
 	QQmlEngine *engine = App::getInstance()->getEngine();
@@ -21,6 +21,7 @@
 #include <QQmlApplicationEngine>
 
 #include "app/App.hpp"
+#include "app/tracer/Tracer.hpp"
 #include "components/contact/ContactModel.hpp"
 #include "components/contact/VcardModel.hpp"
 #include "components/core/CoreManager.hpp"
@@ -32,6 +33,7 @@
 using namespace std;
 
 ContactsListModel::ContactsListModel (QObject *parent) : ProxyListModel(parent) {
+	Tracer::Span span("ContactsListModel::ContactsListModel");
 	mLinphoneFriends = CoreManager::getInstance()->getCore()->getFriendsLists().front();
 	// Clean friends.
 	{
@@ -30,6 +30,7 @@
 #include "app/providers/ThumbnailProvider.hpp"
 
 #include "components/chat-events/ChatMessageModel.hpp"
+#include "components/sound-player/WaveformExtractor.hpp"
 
 #include "utils/QExifImageHeader.hpp"
 #include "utils/Utils.hpp"
@@ -167,10 +168,7 @@ void ContentModel::createThumbnail (const bool& force) {
 					image = QImage(path, format);
 			}
 			if (!image.isNull()){
-				int rotation = 0;
-				QExifImageHeader exifImageHeader;
-				if (exifImageHeader.loadFromJpeg(path))
-					rotation = int(exifImageHeader.value(QExifImageHeader::ImageTag::Orientation).toShort());
+				int rotation = QExifImageHeader::readOrientation(path);
 				QImage thumbnail = image.scaled(
 							Constants::ThumbnailImageFileWidth, Constants::ThumbnailImageFileHeight,
 							Qt::KeepAspectRatio, Qt::SmoothTransformation
@@ -218,6 +216,8 @@ void ContentModel::removeThumbnail(){
 		}
 	}
 	mAppData.mData.clear();
+	if(isVoiceRecording())
+		WaveformExtractor::getInstance()->removeWaveform(getFilePath());
 }
 
 void ContentModel::removeDownloadedFile(){
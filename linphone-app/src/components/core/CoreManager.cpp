@@ -28,6 +28,7 @@
 #include "config.h"
 
 #include "app/paths/Paths.hpp"
+#include "app/tracer/Tracer.hpp"
 #include "components/calls/CallsListModel.hpp"
 #include "components/chat/ChatModel.hpp"
 #include "components/chat-room/ChatRoomModel.hpp"
@@ -37,6 +38,7 @@
 #include "components/history/HistoryModel.hpp"
 #include "components/ldap/LdapListModel.hpp"
 #include "components/recorder/RecorderManager.hpp"
+#include "components/search/MessageSearchIndex.hpp"
 #include "components/settings/AccountSettingsModel.hpp"
 #include "components/settings/SettingsModel.hpp"
 #include "components/sip-addresses/SipAddressesModel.hpp"
@@ -91,6 +93,7 @@ CoreManager::~CoreManager(){
 // -----------------------------------------------------------------------------
 
 void CoreManager::initCoreManager(){
+	Tracer::Span span("CoreManager::initCoreManager");
 	qInfo() << "Init CoreManager";
 	mCallsListModel = new CallsListModel(this);
 	mChatModel = new ChatModel(this);
@@ -102,6 +105,7 @@ void CoreManager::initCoreManager(){
 	mSipAddressesModel = new SipAddressesModel(this);
 	mEventCountNotifier = new EventCountNotifier(this);
 	mTimelineListModel = new TimelineListModel(this);
+	MessageSearchIndex::getInstance()->startBackfill();
 	mEventCountNotifier->updateUnreadMessageCount();
 	QObject::connect(mEventCountNotifier, &EventCountNotifier::eventCountChanged,this, &CoreManager::eventCountChanged);
 	migrate();
@@ -248,16 +252,20 @@ void CoreManager::setResourcesPaths () {
 // -----------------------------------------------------------------------------
 
 void CoreManager::createLinphoneCore (const QString &configPath) {
+	Tracer::Span span("CoreManager::createLinphoneCore");
 	qInfo() << QStringLiteral("Launch async core creation.");
 	
 	// Migration of configuration and database files from GTK version of Linphone.
 	Paths::migrate();
 	setResourcesPaths();
-	mCore = linphone::Factory::get()->createCore(
-				Paths::getConfigFilePath(configPath),
-				Paths::getFactoryConfigFilePath(),
-				nullptr
-				);
+	{
+		Tracer::Span span("linphone::Factory::createCore");
+		mCore = linphone::Factory::get()->createCore(
+					Paths::getConfigFilePath(configPath),
+					Paths::getFactoryConfigFilePath(),
+					nullptr
+					);
+	}
 	// Enable LIME on your core to use encryption.
 	mCore->enableLimeX3Dh(mCore->getLimeX3DhServerUrl() != "");
 	// Now see the CoreService.CreateGroupChatRoom to see how to create a secure chat room
@@ -276,7 +284,10 @@ void CoreManager::createLinphoneCore (const QString &configPath) {
 	}
 	QString userAgent = Utils::computeUserAgent(config);
 	mCore->setUserAgent(Utils::appStringToCoreString(userAgent), mCore->getVersion());
-	mCore->start();
+	{
+		Tracer::Span span("linphone::Core::start");
+		mCore->start();
+	}
 	setDatabasesPaths();
 	setOtherPaths();
 	mCore->enableFriendListSubscription(true);
@@ -18,8 +18,10 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <QTimer>
 #include <QtDebug>
 
+#include "app/tracer/Tracer.hpp"
 #include "components/call/CallModel.hpp"
 #include "components/calls/CallsListModel.hpp"
 #include "components/chat-room/ChatRoomModel.hpp"
@@ -36,7 +38,13 @@
 using namespace std;
 
 AbstractEventCountNotifier::AbstractEventCountNotifier (QObject *parent) : QObject(parent) {
+  Tracer::Span span("AbstractEventCountNotifier::AbstractEventCountNotifier");
   CoreManager *coreManager = CoreManager::getInstance();
+  // Bursts of received messages are coalesced into one badge update per interval.
+  mNotifyTimer = new QTimer(this);
+  mNotifyTimer->setSingleShot(true);
+  mNotifyTimer->setInterval(qMax(0, coreManager->getSettingsModel()->getEventCountUpdateInterval()));
+  QObject::connect(mNotifyTimer, &QTimer::timeout, this, &AbstractEventCountNotifier::handleNotifyTimeout);
   QObject::connect(
     coreManager, &CoreManager::chatRoomModelCreated,
     this, &AbstractEventCountNotifier::handleChatRoomModelCreated
@@ -51,11 +59,11 @@ AbstractEventCountNotifier::AbstractEventCountNotifier (QObject *parent) : QObje
   );
   QObject::connect(
     coreManager->getSettingsModel(), &SettingsModel::standardChatEnabledChanged,
-    this, &AbstractEventCountNotifier::internalnotifyEventCount
+    this, &AbstractEventCountNotifier::requestNotifyEventCount
   );
   QObject::connect(
     coreManager->getSettingsModel(), &SettingsModel::secureChatEnabledChanged,
-    this, &AbstractEventCountNotifier::internalnotifyEventCount
+    this, &AbstractEventCountNotifier::requestNotifyEventCount
   );
   /*
   QObject::connect(
@@ -67,11 +75,33 @@ AbstractEventCountNotifier::AbstractEventCountNotifier (QObject *parent) : QObje
 // -----------------------------------------------------------------------------
 
 void AbstractEventCountNotifier::updateUnreadMessageCount () {
-  mUnreadMessageCount = CoreManager::getInstance()->getCore()->getUnreadChatMessageCountFromActiveLocals();
+  mUnreadMessageCountOutdated = true;
+  requestNotifyEventCount();
+}
+
+// The first request is applied at once, the next ones are delayed until the end of the interval.
+void AbstractEventCountNotifier::requestNotifyEventCount () {
+  if (mNotifyTimer->isActive()) {
+    mNotifyPending = true;
+    return;
+  }
+  internalnotifyEventCount();
+  mNotifyTimer->start();
+}
+
+void AbstractEventCountNotifier::handleNotifyTimeout () {
+  if (!mNotifyPending)
+    return;
+  mNotifyPending = false;
   internalnotifyEventCount();
+  mNotifyTimer->start();
 }
 
 void AbstractEventCountNotifier::internalnotifyEventCount () {
+  if (mUnreadMessageCountOutdated) {
+    mUnreadMessageCountOutdated = false;
+    mUnreadMessageCount = CoreManager::getInstance()->getCore()->getUnreadChatMessageCountFromActiveLocals();
+  }
   int n = mUnreadMessageCount + getMissedCallCount();
   qInfo() << QStringLiteral("Notify event count: %1.").arg(n);
   n = n > 99 ? 99 : n;
@@ -123,7 +153,7 @@ void AbstractEventCountNotifier::handleHistoryModelCreated (HistoryModel *histor
 
 void AbstractEventCountNotifier::handleResetAllMissedCalls () {
   mMissedCalls.clear();
-  internalnotifyEventCount();
+  requestNotifyEventCount();
 }
 
 
@@ -131,16 +161,16 @@ void AbstractEventCountNotifier::handleResetMissedCalls (ChatRoomModel *chatRoom
   auto it = mMissedCalls.find({ Utils::cleanSipAddress(chatRoomModel->getPeerAddress()), Utils::cleanSipAddress(chatRoomModel->getLocalAddress()) });
   if (it != mMissedCalls.cend()) {
     mMissedCalls.erase(it);
-    internalnotifyEventCount();
+    requestNotifyEventCount();
   }
 }
 
 void AbstractEventCountNotifier::handleCallMissed (CallModel *callModel) {
   ++mMissedCalls[{ Utils::cleanSipAddress(callModel->getPeerAddress()), Utils::cleanSipAddress(callModel->getLocalAddress()) }];
-  internalnotifyEventCount();
+  requestNotifyEventCount();
 }
 
 void AbstractEventCountNotifier::handleCallMissed (const QString& localAddress, const QString& peerAddress) {
   ++mMissedCalls[{ peerAddress, localAddress }];
-  internalnotifyEventCount();
+  requestNotifyEventCount();
 }
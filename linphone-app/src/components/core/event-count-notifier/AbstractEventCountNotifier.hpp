@@ -36,6 +36,7 @@ class ChatMessage;
 class CallModel;
 class ChatRoomModel;
 class HistoryModel;
+class QTimer;
 
 class AbstractEventCountNotifier : public QObject {
 	Q_OBJECT
@@ -72,12 +73,18 @@ private:
 	using ConferenceId = QPair<QString, QString>;
 	
 	void internalnotifyEventCount ();
+	void requestNotifyEventCount ();	// Rate-limited call of internalnotifyEventCount.
+	void handleNotifyTimeout ();
 	
 	void handleChatRoomModelCreated (const QSharedPointer<ChatRoomModel> &chatRoomModel);
 	void handleHistoryModelCreated (HistoryModel *historyModel);
 	
 	QHash<ConferenceId, int> mMissedCalls;
 	int mUnreadMessageCount = 0;
+	
+	QTimer *mNotifyTimer = nullptr;
+	bool mNotifyPending = false;
+	bool mUnreadMessageCountOutdated = false;
 };
 
 #endif // ABSTRACT_EVENT_COUNT_NOTIFIER_H_
@@ -29,6 +29,7 @@
 #include "utils/Utils.hpp"
 #include "utils/Constants.hpp"
 #include "components/other/colors/ColorListModel.hpp"
+#include "components/other/colors/ColorModel.hpp"
 
 #include "EventCountNotifierSystemTrayIcon.hpp"
 
@@ -55,7 +56,14 @@ EventCountNotifier::EventCountNotifier (QObject *parent) : AbstractEventCountNot
   renderer.render(&painter);
 
   mBuf = new QPixmap(buf);
-  mBufWithCounter = new QPixmap();
+  mIcon = QIcon(*mBuf);
+
+  // Resolve badge colors once and drop rendered badges when the theme changes them.
+  ColorListModel *colorListModel = App::getInstance()->getColorListModel();
+  mBadgeBackgroundColor = colorListModel->addImageColor("Logo_tray_blink_bg", Constants::WindowIconPath,"b");
+  mBadgeForegroundColor = colorListModel->addImageColor("Logo_tray_blink_fg", Constants::WindowIconPath,"ai");
+  QObject::connect(mBadgeBackgroundColor, &ColorModel::colorChanged, this, &EventCountNotifier::clearBadgeIcons);
+  QObject::connect(mBadgeForegroundColor, &ColorModel::colorChanged, this, &EventCountNotifier::clearBadgeIcons);
 
   mBlinkTimer = new QTimer(this);
   mBlinkTimer->setInterval(IconCounterBlinkInterval);
@@ -69,29 +77,24 @@ EventCountNotifier::EventCountNotifier (QObject *parent) : AbstractEventCountNot
 
 EventCountNotifier::~EventCountNotifier () {
   delete mBuf;
-  delete mBufWithCounter;
 }
 
-void EventCountNotifier::notifyEventCount (int n) {
-  QSystemTrayIcon *sysTrayIcon = App::getInstance()->getSystemTrayIcon();
-  if (!sysTrayIcon)
-    return;
+// -----------------------------------------------------------------------------
 
-  if (!n) {
-    mBlinkTimer->stop();
-    sysTrayIcon->setIcon(QIcon(*mBuf));
-    return;
-  }
+const QIcon &EventCountNotifier::getBadgeIcon (int n) {
+  auto it = mBadgeIcons.find(n);
+  if (it != mBadgeIcons.end())
+    return *it;
 
-  *mBufWithCounter = *mBuf;
-  QPainter p(mBufWithCounter);
+  QPixmap bufWithCounter(*mBuf);
+  QPainter p(&bufWithCounter);
 
-  const int width = mBufWithCounter->width();
-  const int height = mBufWithCounter->height();
+  const int width = bufWithCounter.width();
+  const int height = bufWithCounter.height();
 
   // Draw background.
   {
-    p.setBrush(App::getInstance()->getColorListModel()->addImageColor("Logo_tray_blink_bg", Constants::WindowIconPath,"b")->getColor());
+    p.setBrush(mBadgeBackgroundColor->getColor());
     p.drawEllipse(QPointF(width / 2, height / 2), IconCounterBackgroundRadius, IconCounterBackgroundRadius);
   }
 
@@ -101,9 +104,38 @@ void EventCountNotifier::notifyEventCount (int n) {
     font.setPixelSize(IconCounterTextPixelSize);
 
     p.setFont(font);
-    p.setPen(QPen(App::getInstance()->getColorListModel()->addImageColor("Logo_tray_blink_fg", Constants::WindowIconPath,"ai")->getColor(), 1));
+    p.setPen(QPen(mBadgeForegroundColor->getColor(), 1));
     p.drawText(QRect(0, 0, width, height), Qt::AlignCenter, QString::number(n));
   }
+  p.end();
+
+  return *mBadgeIcons.insert(n, QIcon(bufWithCounter));
+}
+
+void EventCountNotifier::clearBadgeIcons () {
+  mBadgeIcons.clear();
+  if (mCount > 0) {	// Render again the displayed badge.
+    mDisplayCounter = true;
+    update();
+  }
+}
+
+// -----------------------------------------------------------------------------
+
+void EventCountNotifier::notifyEventCount (int n) {
+  QSystemTrayIcon *sysTrayIcon = App::getInstance()->getSystemTrayIcon();
+  if (!sysTrayIcon)
+    return;
+
+  if (n == mCount)	// Nothing to render : keep blinking with the current badge.
+    return;
+  mCount = n;
+
+  if (!n) {
+    mBlinkTimer->stop();
+    sysTrayIcon->setIcon(mIcon);
+    return;
+  }
 
   // Change counter.
   mBlinkTimer->stop();
@@ -115,6 +147,6 @@ void EventCountNotifier::notifyEventCount (int n) {
 void EventCountNotifier::update () {
   QSystemTrayIcon *sysTrayIcon = App::getInstance()->getSystemTrayIcon();
   if(sysTrayIcon)
-    sysTrayIcon->setIcon(QIcon(mDisplayCounter ? *mBufWithCounter : *mBuf));
+    sysTrayIcon->setIcon(mDisplayCounter && mCount > 0 ? getBadgeIcon(mCount) : mIcon);
   mDisplayCounter = !mDisplayCounter;
 }
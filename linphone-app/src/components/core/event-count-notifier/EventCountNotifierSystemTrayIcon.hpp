@@ -21,10 +21,13 @@
 #ifndef EVENT_COUNT_NOTIFIER_SYSTEM_TRAY_ICON_H_
 #define EVENT_COUNT_NOTIFIER_SYSTEM_TRAY_ICON_H_
 
+#include <QIcon>
+
 #include "AbstractEventCountNotifier.hpp"
 
 // =============================================================================
 
+class ColorModel;
 class QTimer;
 
 class EventCountNotifier : public AbstractEventCountNotifier {
@@ -38,9 +41,17 @@ protected:
 private:
   void update ();
 
+  // Badges are rendered once per count and theme, then reused.
+  const QIcon &getBadgeIcon (int n);
+  void clearBadgeIcons ();
+
   const QPixmap *mBuf = nullptr;
-  QPixmap *mBufWithCounter = nullptr;
+  QIcon mIcon;
+  QHash<int, QIcon> mBadgeIcons;
+  ColorModel *mBadgeBackgroundColor = nullptr;
+  ColorModel *mBadgeForegroundColor = nullptr;
   QTimer *mBlinkTimer = nullptr;
+  int mCount = 0;
   bool mDisplayCounter = false;
 };
 
@@ -18,7 +18,12 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
 #include <QTest>
+
 #include "app/paths/Paths.hpp"
 #include "components/core/CoreManager.hpp"
 #include "components/settings/SettingsModel.hpp"
@@ -30,8 +35,16 @@
 
 namespace {
 constexpr char cDefaultFileName[] = "download";
+constexpr char cPartialFileSuffix[] = ".part";
+constexpr char cResumeInfoFileSuffix[] = ".part.info";
 }
 
+constexpr int FileDownloader::MaxSegments;
+constexpr qint64 FileDownloader::MinSegmentSize;
+constexpr int FileDownloader::MaxRetries;
+constexpr qint64 FileDownloader::MaxChecksumCatchUp;
+constexpr qint64 FileDownloader::ChecksumChunkSize;
+
 static QString getDownloadFilePath (const QString &folder, const QUrl &url, const bool& overwrite) {
 	QFileInfo fileInfo(url.path());
 	QString fileName = fileInfo.fileName();
@@ -61,6 +74,11 @@ static QString getDownloadFilePath (const QString &folder, const QUrl &url, cons
 	return fileName;
 }
 
+// The same request may succeed later : keep the partial file to resume it.
+static bool isTransientErrorStatus (int statusCode) {
+	return statusCode == 408 || statusCode == 429 || statusCode >= 500;
+}
+
 static bool isHttpRedirect (QNetworkReply *reply) {
 	Q_CHECK_PTR(reply);
 	int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
@@ -68,20 +86,152 @@ static bool isHttpRedirect (QNetworkReply *reply) {
 			|| statusCode == 305 || statusCode == 307 || statusCode == 308;
 }
 
+// Strong validator of the file for `If-Range`.
+static QByteArray getValidator (QNetworkReply *reply) {
+	QByteArray eTag = reply->rawHeader("ETag");
+	if (!eTag.isEmpty() && !eTag.startsWith("W/"))
+		return eTag;
+	return reply->rawHeader("Last-Modified");
+}
+
+// Parse `bytes <first>-<last>/<length>`. `length` is -1 if unknown.
+static bool parseContentRange (const QByteArray &contentRange, qint64 &first, qint64 &length) {
+	static const QRegularExpression regex("^bytes (\\d+)-(\\d+)/(\\d+|\\*)$");
+	QRegularExpressionMatch match = regex.match(QString::fromLatin1(contentRange).trimmed());
+	if (!match.hasMatch())
+		return false;
+	first = match.captured(1).toLongLong();
+	length = match.captured(3) == "*" ? -1 : match.captured(3).toLongLong();
+	return true;
+}
+
+// Parse `<algorithm>:<hex>` or `<hex>` for sha256.
+static bool parseChecksum (const QString &checksum, QCryptographicHash::Algorithm &algorithm, QByteArray &hash) {
+	static const QHash<QString, QCryptographicHash::Algorithm> algorithms{
+		{ "md5", QCryptographicHash::Md5 },
+		{ "sha1", QCryptographicHash::Sha1 },
+		{ "sha256", QCryptographicHash::Sha256 },
+		{ "sha512", QCryptographicHash::Sha512 }
+	};
+	const int separator = checksum.indexOf(':');
+	auto it = algorithms.find(separator < 0 ? QStringLiteral("sha256") : checksum.left(separator).trimmed().toLower());
+	if (it == algorithms.end())
+		return false;
+	algorithm = *it;
+	hash = QByteArray::fromHex(checksum.mid(separator + 1).trimmed().toLatin1());
+	return hash.size() == QCryptographicHash::hash(QByteArray(), algorithm).size();
+}
+
 // -----------------------------------------------------------------------------
 
+FileDownloader::~FileDownloader () {
+	if (!mDownloading)
+		return;
+	// Keep what is already downloaded, the next download of the same url resumes it.
+	abortReplies();
+	mDestinationFile.close();
+	if (canResume())
+		saveResumeInfo();
+	else
+		removePartialFile();
+}
+
 void FileDownloader::download () {
 	if (mDownloading) {
 		qWarning() << "Unable to download file. Already downloading!";
 		return;
 	}
+	if (!initChecksum()) {
+		qWarning() << QStringLiteral("Unable to download %1: invalid checksum `%2`.").arg(mUrl.toString(), mChecksum);
+		emit downloadFailed();
+		return;
+	}
 	setDownloading(true);
 	
+	if (mDownloadFolder.isEmpty()) {
+		if(CoreManager::isInstanciated())
+			mDownloadFolder = CoreManager::getInstance()->getSettingsModel()->getDownloadFolder();
+		else
+			mDownloadFolder =  QDir::cleanPath(Utils::coreStringToAppString(Paths::getDownloadDirPath ()) + QDir::separator());
+		emit downloadFolderChanged(mDownloadFolder);
+	}
+	
+	Q_ASSERT(!mDestinationFile.isOpen());
+	mDestinationFilePath = getDownloadFilePath(QDir::cleanPath(mDownloadFolder) + QDir::separator(), mUrl, mOverwriteFile);
+	mDestinationFile.setFileName(mDestinationFilePath + cPartialFileSuffix);
+	mSegments.clear();
+	mValidator.clear();
+	setReadBytes(0);
+	setTotalBytes(0);
+	if (!loadResumeInfo())
+		removePartialFile();
+	
+	if (!mDestinationFile.open(QIODevice::ReadWrite)) {
+		emitOutputError();
+		return;
+	}
+	mTimeoutReadBytes = mReadBytes;
+	mTimeout.start();
+	
+	if (!mSegments.isEmpty()) {
+		qInfo() << QStringLiteral("Resume download of %1 from %2 bytes.").arg(mUrl.toString()).arg(mReadBytes);
+		requestSegments();
+	} else if (mSegmentCount > 1)
+		requestHead();
+	else {
+		mSegments << Segment();
+		requestSegments();
+	}
+}
+
+bool FileDownloader::remove () {
+	return !mDownloading && QFile::exists(mDestinationFilePath) && QFile::remove(mDestinationFilePath);
+}
+
+void FileDownloader::emitOutputError () {
+	qWarning() << QStringLiteral("Could not write into `%1` (%2).")
+				  .arg(mDestinationFile.fileName()).arg(mDestinationFile.errorString());
+	fail(false);
+}
+
+// -----------------------------------------------------------------------------
+
+// Ask the size of the file and if ranges are supported to split the download.
+void FileDownloader::requestHead () {
 	QNetworkRequest request(mUrl);
 	request.setAttribute(QNetworkRequest::FollowRedirectsAttribute, true);
-	mNetworkReply = mManager.get(request);
+	mHeadReply = mManager.head(request);
+	QObject::connect(mHeadReply.data(), &QNetworkReply::finished, this, &FileDownloader::handleHeadFinished);
+}
+
+void FileDownloader::requestSegments () {
+	bool isComplete = true;
+	for (int i = 0; i < mSegments.size(); ++i)
+		if (!mSegments[i].isComplete()) {
+			startSegment(i);
+			isComplete = false;
+		}
+	updateReadBytes();
+	if (isComplete)
+		finish();
+}
+
+void FileDownloader::startSegment (int index) {
+	Segment &segment = mSegments[index];
+	QNetworkRequest request(mUrl);
+	request.setAttribute(QNetworkRequest::FollowRedirectsAttribute, true);
+	if (segment.hasRange()) {
+		request.setRawHeader("Range", "bytes=" + QByteArray::number(segment.offset) + "-" + (
+			segment.end >= 0 ? QByteArray::number(segment.end) : QByteArray()
+		));
+		// The server sends the full file if it has changed since the first request.
+		if (!mValidator.isEmpty())
+			request.setRawHeader("If-Range", mValidator);
+	}
+	segment.checked = false;
+	segment.reply = mManager.get(request);
 	
-	QNetworkReply *data = mNetworkReply.data();
+	QNetworkReply *data = segment.reply.data();
 	
 	QObject::connect(data, &QNetworkReply::readyRead, this, &FileDownloader::handleReadyData);
 	QObject::connect(data, &QNetworkReply::finished, this, &FileDownloader::handleDownloadFinished);
@@ -90,78 +240,393 @@ void FileDownloader::download () {
 #else
 	QObject::connect(data, QNonConstOverload<QNetworkReply::NetworkError>::of(&QNetworkReply::error), this, &FileDownloader::handleError);
 #endif
-	QObject::connect(data, &QNetworkReply::downloadProgress, this, &FileDownloader::handleDownloadProgress);
 	
 #if QT_CONFIG(ssl)
 	QObject::connect(data, &QNetworkReply::sslErrors, this, &FileDownloader::handleSslErrors);
 #endif
+}
+
+// Download the whole file again in one request.
+void FileDownloader::restart () {
+	qInfo() << QStringLiteral("Unable to resume download of %1, restart it.").arg(mUrl.toString());
+	abortReplies();
+	mSegments.clear();
+	mSegments << Segment();
+	mValidator.clear();
+	mDestinationFile.resize(0);
+	initChecksum();
+	setTotalBytes(0);
+	startSegment(0);
+	updateReadBytes();
+}
+
+void FileDownloader::finish () {
+	mTimeout.stop();
+	catchUpChecksum(-1);
+	if (mHash && mHash->result() != mExpectedHash) {
+		qWarning() << QStringLiteral("Download of %1 failed: bad checksum (expected %2, got %3).")
+					  .arg(mUrl.toString())
+					  .arg(QString::fromLatin1(mExpectedHash.toHex()))
+					  .arg(QString::fromLatin1(mHash->result().toHex()));
+		fail(false);
+		return;
+	}
 	
-	if (mDownloadFolder.isEmpty()) {
-		if(CoreManager::isInstanciated())
-			mDownloadFolder = CoreManager::getInstance()->getSettingsModel()->getDownloadFolder();
-		else
-			mDownloadFolder =  QDir::cleanPath(Utils::coreStringToAppString(Paths::getDownloadDirPath ()) + QDir::separator());
-		emit downloadFolderChanged(mDownloadFolder);
+	mDestinationFile.close();
+	if (!mDestinationFile.rename(mDestinationFilePath)) {
+		qWarning() << QStringLiteral("Unable to rename `%1` to `%2` (%3).")
+					  .arg(mDestinationFile.fileName()).arg(mDestinationFilePath).arg(mDestinationFile.errorString());
+		fail(false);
+		return;
 	}
+	QFile::remove(getResumeInfoFilePath());
+	mSegments.clear();
 	
-	Q_ASSERT(!mDestinationFile.isOpen());
-	mDestinationFile.setFileName(getDownloadFilePath(QDir::cleanPath(mDownloadFolder) + QDir::separator(), mUrl, mOverwriteFile));
-	if (!mDestinationFile.open(QIODevice::WriteOnly))
+	qInfo() << QStringLiteral("Download of %1 finished to %2").arg(mUrl.toString(), mDestinationFilePath);
+	setDownloading(false);
+	emit downloadFinished(mDestinationFilePath);
+}
+
+void FileDownloader::fail (bool keepPartialFile) {
+	abortReplies();
+	mTimeout.stop();
+	mDestinationFile.close();
+	if (keepPartialFile && canResume())
+		saveResumeInfo();
+	else
+		removePartialFile();
+	mSegments.clear();
+	
+	setDownloading(false);
+	emit downloadFailed();
+}
+
+void FileDownloader::abortReplies () {
+	QList<QNetworkReply *> replies;
+	if (mHeadReply)
+		replies << mHeadReply.data();
+	mHeadReply = nullptr;
+	for (Segment &segment : mSegments)
+		if (segment.reply) {
+			replies << segment.reply.data();
+			segment.reply = nullptr;
+		}
+	
+	for (QNetworkReply *reply : replies) {
+		QObject::disconnect(reply, nullptr, this, nullptr);
+		reply->abort();
+		reply->deleteLater();
+	}
+}
+
+// -----------------------------------------------------------------------------
+
+int FileDownloader::getSegmentIndex (QNetworkReply *reply) const {
+	if (reply)
+		for (int i = 0; i < mSegments.size(); ++i)
+			if (mSegments[i].reply == reply)
+				return i;
+	return -1;
+}
+
+// Check that the reply contains the requested range. Return false if the reply must be ignored.
+bool FileDownloader::checkResponse (int index) {
+	Segment &segment = mSegments[index];
+	if (segment.checked)
+		return true;
+	
+	QNetworkReply *reply = segment.reply.data();
+	if (isHttpRedirect(reply))
+		return false;// Handled at the end of the request.
+	segment.checked = true;
+	
+	const int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+	if (statusCode == 206) {
+		qint64 first, length;
+		if (!parseContentRange(reply->rawHeader("Content-Range"), first, length) || first != segment.offset) {
+			restart();
+			return false;
+		}
+		if (length >= 0)
+			setTotalBytes(length);
+		return true;
+	}
+	
+	// Only 200 means that the range is ignored.
+	if (statusCode != 200 && reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).isValid()) {
+		handleErrorStatus(index, statusCode);
+		return false;
+	}
+	
+	if (mSegments.size() > 1) {
+		restart();
+		return false;
+	}
+	
+	// Full file: new download or the server can't resume it.
+	if (segment.hasRange()) {
+		qInfo() << QStringLiteral("Unable to resume download of %1, download the full file.").arg(mUrl.toString());
+		segment.offset = 0;
+		mDestinationFile.resize(0);
+		initChecksum();
+	}
+	mValidator = getValidator(reply);
+	const QVariant length = reply->header(QNetworkRequest::ContentLengthHeader);
+	if (length.isValid()) {
+		setTotalBytes(length.toLongLong());
+		// The length of encoded contents is not the length of the file.
+		if (reply->rawHeader("Content-Encoding").isEmpty())
+			segment.end = mTotalBytes - 1;
+	}
+	return true;
+}
+
+bool FileDownloader::writeSegmentData (int index) {
+	Segment &segment = mSegments[index];
+	QByteArray data = segment.reply->readAll();
+	if (segment.end >= 0 && data.size() > segment.end + 1 - segment.offset)
+		data.truncate(int(segment.end + 1 - segment.offset));
+	if (data.isEmpty())
+		return true;
+	
+	if (!mDestinationFile.seek(segment.offset) || mDestinationFile.write(data) != data.size()) {
 		emitOutputError();
-	else {
-		mTimeoutReadBytes = 0;
-		mTimeout.start();
+		return false;
 	}
+	const qint64 position = segment.offset;
+	segment.offset += data.size();
+	updateChecksum(position, data);
+	return true;
 }
 
-bool FileDownloader::remove () {
-	return mDestinationFile.exists() && !mDestinationFile.isOpen() && mDestinationFile.remove();
+void FileDownloader::updateReadBytes () {
+	qint64 readBytes = 0;
+	for (const Segment &segment : mSegments)
+		readBytes += segment.offset - segment.start;
+	setReadBytes(readBytes);
 }
 
-void FileDownloader::emitOutputError () {
-	qWarning() << QStringLiteral("Could not write into `%1` (%2).")
-				  .arg(mDestinationFile.fileName()).arg(mDestinationFile.errorString());
-	mNetworkReply->abort();
+// -----------------------------------------------------------------------------
+
+bool FileDownloader::initChecksum () {
+	mHashedBytes = 0;
+	mHash.reset();
+	if (mChecksum.isEmpty())
+		return true;
+	
+	QCryptographicHash::Algorithm algorithm;
+	if (!parseChecksum(mChecksum, algorithm, mExpectedHash))
+		return false;
+	mHash.reset(new QCryptographicHash(algorithm));
+	return true;
 }
 
-void FileDownloader::cleanDownloadEnd () {
-	mTimeout.stop();
-	mNetworkReply->deleteLater();
-	setDownloading(false);
+void FileDownloader::updateChecksum (qint64 position, const QByteArray &data) {
+	if (!mHash)
+		return;
+	if (position == mHashedBytes) {
+		mHash->addData(data);
+		mHashedBytes += data.size();
+	}
+	catchUpChecksum(MaxChecksumCatchUp);
+}
+
+// Hash data written after the hashed prefix: resumed data and following segments.
+// Read at most `maxBytes` from the file, -1 to hash everything available.
+void FileDownloader::catchUpChecksum (qint64 maxBytes) {
+	if (!mHash)
+		return;
+	for (const Segment &segment : mSegments) {
+		if (segment.start > mHashedBytes)
+			return;
+		while (mHashedBytes < segment.offset) {
+			qint64 size = qMin<qint64>(segment.offset - mHashedBytes, ChecksumChunkSize);
+			if (maxBytes >= 0) {
+				if (maxBytes == 0)
+					return;
+				size = qMin(size, maxBytes);
+				maxBytes -= size;
+			}
+			if (!mDestinationFile.seek(mHashedBytes))
+				return;
+			const QByteArray data = mDestinationFile.read(size);
+			if (data.isEmpty())
+				return;
+			mHash->addData(data);
+			mHashedBytes += data.size();
+		}
+	}
+}
+
+// -----------------------------------------------------------------------------
+
+QString FileDownloader::getResumeInfoFilePath () const {
+	return mDestinationFilePath + cResumeInfoFileSuffix;
+}
+
+bool FileDownloader::canResume () const {
+	return !mValidator.isEmpty() && !mSegments.isEmpty() && mReadBytes > 0;
+}
+
+bool FileDownloader::loadResumeInfo () {
+	QFile file(getResumeInfoFilePath());
+	if (!mDestinationFile.exists() || !file.open(QIODevice::ReadOnly))
+		return false;
+	
+	const QJsonObject info = QJsonDocument::fromJson(file.readAll()).object();
+	const QByteArray validator = info["validator"].toString().toLatin1();
+	if (info["url"].toString() != mUrl.toString() || validator.isEmpty())
+		return false;
+	
+	const qint64 partialFileSize = mDestinationFile.size();
+	QVector<Segment> segments;
+	qint64 start = 0;
+	for (const QJsonValue &value : info["segments"].toArray()) {
+		const QJsonArray range = value.toArray();
+		Segment segment;
+		segment.start = qint64(range.at(0).toDouble());
+		segment.offset = qint64(range.at(1).toDouble());
+		segment.end = qint64(range.at(2).toDouble(-1));
+		if (
+			segment.start != start || segment.offset < segment.start || segment.offset > partialFileSize ||
+			(segment.end >= 0 && segment.offset > segment.end + 1)
+		)
+			return false;
+		start = segment.end + 1;
+		segments << segment;
+	}
+	if (segments.isEmpty())
+		return false;
+	
+	mSegments = segments;
+	mValidator = validator;
+	setTotalBytes(qint64(info["totalBytes"].toDouble()));
+	updateReadBytes();
+	return true;
+}
+
+void FileDownloader::saveResumeInfo () {
+	QJsonArray segments;
+	for (const Segment &segment : mSegments)
+		segments.append(QJsonArray{ double(segment.start), double(segment.offset), double(segment.end) });
+	
+	QFile file(getResumeInfoFilePath());
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		qWarning() << QStringLiteral("Unable to save resume info of `%1`.").arg(mDestinationFile.fileName());
+		return;
+	}
+	mDestinationFile.flush();
+	file.write(QJsonDocument(QJsonObject{
+		{ "url", mUrl.toString() },
+		{ "validator", QString::fromLatin1(mValidator) },
+		{ "totalBytes", double(mTotalBytes) },
+		{ "segments", segments }
+	}).toJson(QJsonDocument::Compact));
+}
+
+void FileDownloader::removePartialFile () {
+	mDestinationFile.remove();
+	QFile::remove(getResumeInfoFilePath());
+}
+
+// -----------------------------------------------------------------------------
+
+void FileDownloader::handleHeadFinished () {
+	QNetworkReply *reply = mHeadReply.data();
+	mHeadReply = nullptr;
+	reply->deleteLater();
+	
+	const qint64 length = reply->header(QNetworkRequest::ContentLengthHeader).toLongLong();
+	const int segmentCount = int(qMin<qint64>(mSegmentCount, length / MinSegmentSize));
+	if (
+		reply->error() == QNetworkReply::NoError && segmentCount > 1 &&
+		reply->rawHeader("Accept-Ranges") == "bytes" && reply->rawHeader("Content-Encoding").isEmpty()
+	) {
+		// Preallocate the file, each segment writes at its own position.
+		if (!mDestinationFile.resize(length)) {
+			emitOutputError();
+			return;
+		}
+		mValidator = getValidator(reply);
+		setTotalBytes(length);
+		const qint64 segmentSize = length / segmentCount;
+		for (int i = 0; i < segmentCount; ++i) {
+			Segment segment;
+			segment.start = segment.offset = i * segmentSize;
+			segment.end = i == segmentCount - 1 ? length - 1 : segment.start + segmentSize - 1;
+			mSegments << segment;
+		}
+	} else
+		mSegments << Segment();
+	requestSegments();
 }
 
 void FileDownloader::handleReadyData () {
-	QByteArray data = mNetworkReply->readAll();
-	if (mDestinationFile.write(data) == -1)
-		emitOutputError();
+	const int index = getSegmentIndex(qobject_cast<QNetworkReply *>(sender()));
+	if (index >= 0 && checkResponse(index) && writeSegmentData(index))
+		updateReadBytes();
 }
 
 void FileDownloader::handleDownloadFinished() {
-	if (mNetworkReply->error() != QNetworkReply::NoError)
+	QNetworkReply *reply = qobject_cast<QNetworkReply *>(sender());
+	const int index = getSegmentIndex(reply);
+	if (index < 0 || reply->error() != QNetworkReply::NoError)
 		return;
 	
-	if (isHttpRedirect(mNetworkReply)) {
+	if (isHttpRedirect(reply)) {
 		qWarning() << QStringLiteral("Request was redirected.");
-		mDestinationFile.remove();
-		cleanDownloadEnd();
-		emit downloadFailed();
-	} else {
-		qInfo() << QStringLiteral("Download of %1 finished to %2").arg(mUrl.toString(), mDestinationFile.fileName());
-		mDestinationFile.close();
-		cleanDownloadEnd();
-		emit downloadFinished(mDestinationFile.fileName());
+		fail(false);
+		return;
 	}
+	if (!checkResponse(index) || !writeSegmentData(index))
+		return;
+	
+	Segment &segment = mSegments[index];
+	segment.reply = nullptr;
+	reply->deleteLater();
+	if (segment.end < 0)
+		segment.end = segment.offset - 1;// Unknown size, all is received.
+	else if (!segment.isComplete()) {
+		// The connection was closed too early.
+		if (++segment.retries > MaxRetries) {
+			qWarning() << QStringLiteral("Download of %1 failed: incomplete response.").arg(mUrl.toString());
+			fail(true);
+		} else
+			startSegment(index);
+		return;
+	}
+	updateReadBytes();
+	
+	for (const Segment &other : mSegments)
+		if (!other.isComplete())
+			return;
+	finish();
+}
+
+void FileDownloader::handleErrorStatus (int index, int statusCode) {
+	// The partial file doesn't match the file anymore : download it again from the first byte.
+	if (statusCode == 416 && mSegments[index].hasRange()) {
+		restart();
+		return;
+	}
+	qWarning() << QStringLiteral("Download of %1 failed: HTTP status %2.").arg(mUrl.toString()).arg(statusCode);
+	fail(isTransientErrorStatus(statusCode));
 }
 
 void FileDownloader::handleError (QNetworkReply::NetworkError code) {
+	QNetworkReply *reply = qobject_cast<QNetworkReply *>(sender());
+	const int index = getSegmentIndex(reply);
+	if (index < 0)
+		return;
+	const QVariant statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute);
+	if (statusCode.isValid() && statusCode.toInt() >= 400) {// Error response without body.
+		handleErrorStatus(index, statusCode.toInt());
+		return;
+	}
 	if (code != QNetworkReply::OperationCanceledError)
 		qWarning() << QStringLiteral("Download of %1 failed: %2")
-					  .arg(mUrl.toString()).arg(mNetworkReply->errorString());
-	mDestinationFile.remove();
-	
-	cleanDownloadEnd();
-	
-	emit downloadFailed();
+					  .arg(mUrl.toString()).arg(reply->errorString());
+	fail(true);
 }
 
 void FileDownloader::handleSslErrors (const QList<QSslError> &sslErrors) {
@@ -176,14 +641,13 @@ void FileDownloader::handleSslErrors (const QList<QSslError> &sslErrors) {
 void FileDownloader::handleTimeout () {
 	if (mReadBytes == mTimeoutReadBytes) {
 		qWarning() << QStringLiteral("Download of %1 failed: timeout.").arg(mUrl.toString());
-		mNetworkReply->abort();
-	} else
+		fail(true);
+	} else {
 		mTimeoutReadBytes = mReadBytes;
-}
-
-void FileDownloader::handleDownloadProgress (qint64 readBytes, qint64 totalBytes) {
-	setReadBytes(readBytes);
-	setTotalBytes(totalBytes);
+		// Keep a resume point if the application is killed.
+		if (canResume())
+			saveResumeInfo();
+	}
 }
 
 // -----------------------------------------------------------------------------
@@ -225,13 +689,41 @@ void FileDownloader::setDownloadFolder (const QString &downloadFolder) {
 }
 
 QString FileDownloader::getDestinationFileName () const{
-	return mDestinationFile.fileName();
+	return mDestinationFilePath;
 }
 
 void FileDownloader::setOverwriteFile(const bool &overwrite){
 	mOverwriteFile = overwrite;
 }
 
+QString FileDownloader::getChecksum () const {
+	return mChecksum;
+}
+
+void FileDownloader::setChecksum (const QString &checksum) {
+	if (mDownloading) {
+		qWarning() << QStringLiteral("Unable to set checksum, a file is downloading.");
+		return;
+	}
+	
+	if (mChecksum != checksum) {
+		mChecksum = checksum;
+		emit checksumChanged(mChecksum);
+	}
+}
+
+int FileDownloader::getSegments () const {
+	return mSegmentCount;
+}
+
+void FileDownloader::setSegments (int segments) {
+	segments = qBound(1, segments, MaxSegments);
+	if (mSegmentCount != segments) {
+		mSegmentCount = segments;
+		emit segmentsChanged(mSegmentCount);
+	}
+}
+
 QString FileDownloader::synchronousDownload(const QUrl &url, const QString &destinationFolder, const bool &overwriteFile){
 	QString filePath;
 	FileDownloader downloader;
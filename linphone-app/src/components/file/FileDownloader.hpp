@@ -21,6 +21,9 @@
 #ifndef FILE_DOWNLOADER_H_
 #define FILE_DOWNLOADER_H_
 
+#include <memory>
+
+#include <QCryptographicHash>
 #include <QObject>
 #include <QtNetwork>
 #include <QThread>
@@ -39,6 +42,8 @@ class FileDownloader : public QObject{
   Q_PROPERTY(qint64 readBytes READ getReadBytes NOTIFY readBytesChanged);
   Q_PROPERTY(qint64 totalBytes READ getTotalBytes NOTIFY totalBytesChanged);
   Q_PROPERTY(bool downloading READ getDownloading NOTIFY downloadingChanged);
+  Q_PROPERTY(QString checksum READ getChecksum WRITE setChecksum NOTIFY checksumChanged);
+  Q_PROPERTY(int segments READ getSegments WRITE setSegments NOTIFY segmentsChanged);
 
 public:
   FileDownloader (QObject *parent = Q_NULLPTR) : QObject(parent) {
@@ -47,7 +52,7 @@ public:
     QObject::connect(&mTimeout, &QTimer::timeout, this, &FileDownloader::handleTimeout);
   }
 
-  ~FileDownloader () { if (mNetworkReply) mNetworkReply->abort(); }
+  ~FileDownloader ();
 
   Q_INVOKABLE void download ();
   Q_INVOKABLE bool remove();
@@ -61,6 +66,16 @@ public:
   QString getDestinationFileName () const;
 
   void setOverwriteFile(const bool &overwrite);
+
+  // Expected checksum of the file, verified while downloading: `<algorithm>:<hex>`
+  // with md5, sha1, sha256 or sha512 as algorithm, or only `<hex>` for sha256.
+  QString getChecksum () const;
+  void setChecksum (const QString &checksum);
+
+  // Number of parallel range requests, used if the server supports them.
+  int getSegments () const;
+  void setSegments (int segments);
+
   static QString synchronousDownload(const QUrl &url, const QString &destinationFolder, const bool &overwriteFile);// Return the filpath. Empty if nof file could be downloaded
 
 signals:
@@ -69,10 +84,25 @@ signals:
   void readBytesChanged (qint64 readBytes);
   void totalBytesChanged (qint64 totalBytes);
   void downloadingChanged (bool downloading);
+  void checksumChanged (const QString &checksum);
+  void segmentsChanged (int segments);
   void downloadFinished (const QString &filePath);
   void downloadFailed();
 
 private:
+  // A range of the file. One request by segment.
+  struct Segment {
+    qint64 start = 0;
+    qint64 offset = 0; // Next byte to write.
+    qint64 end = -1; // Last byte. -1 if unknown.
+    bool checked = false; // Response status and range are checked.
+    int retries = 0;
+    QPointer<QNetworkReply> reply;
+
+    bool hasRange () const { return offset > 0 || end >= 0; }
+    bool isComplete () const { return end >= 0 && offset > end; }
+  };
+
   qint64 getReadBytes () const;
   void setReadBytes (qint64 readBytes);
 
@@ -84,32 +114,69 @@ private:
 
   void emitOutputError ();
 
-  void cleanDownloadEnd ();
-
+  void requestHead ();
+  void requestSegments ();
+  void startSegment (int index);
+  void restart ();
+  void finish ();
+  void fail (bool keepPartialFile);
+  void abortReplies ();
+
+  int getSegmentIndex (QNetworkReply *reply) const;
+  bool checkResponse (int index);
+  bool writeSegmentData (int index);
+  void updateReadBytes ();
+
+  bool initChecksum ();
+  void updateChecksum (qint64 position, const QByteArray &data);
+  void catchUpChecksum (qint64 maxBytes);
+
+  QString getResumeInfoFilePath () const;
+  bool canResume () const;
+  bool loadResumeInfo ();
+  void saveResumeInfo ();
+  void removePartialFile ();
+
+  void handleHeadFinished ();
   void handleReadyData ();
   void handleDownloadFinished ();
 
+  void handleErrorStatus (int index, int statusCode);
   void handleError (QNetworkReply::NetworkError code);
   void handleSslErrors (const QList<QSslError> &errors);
   void handleTimeout ();
-  void handleDownloadProgress (qint64 readBytes, qint64 totalBytes);
 
   QUrl mUrl;
   QString mDownloadFolder;
-  QFile mDestinationFile;
+  QString mDestinationFilePath;
+  QFile mDestinationFile; // The partial file while downloading.
 
   qint64 mReadBytes = 0;
   qint64 mTotalBytes = 0;
   bool mDownloading = false;
   bool mOverwriteFile = false;
 
-  QPointer<QNetworkReply> mNetworkReply;
+  QString mChecksum;
+  QByteArray mExpectedHash;
+  std::unique_ptr<QCryptographicHash> mHash;
+  qint64 mHashedBytes = 0; // The hash covers [0, mHashedBytes[.
+
+  int mSegmentCount = 1;
+  QVector<Segment> mSegments;
+  QByteArray mValidator; // ETag or Last-Modified of the file, used to resume.
+
+  QPointer<QNetworkReply> mHeadReply;
   QNetworkAccessManager mManager;
 
   qint64 mTimeoutReadBytes;
   QTimer mTimeout;
 
   static constexpr int DefaultTimeout = 5000;
+  static constexpr int MaxSegments = 8;
+  static constexpr qint64 MinSegmentSize = 1024 * 1024;
+  static constexpr int MaxRetries = 3;
+  static constexpr qint64 MaxChecksumCatchUp = 4 * 1024 * 1024;
+  static constexpr qint64 ChecksumChunkSize = 1024 * 1024;
 };
 
 #endif // FILE_DOWNLOADER_H_
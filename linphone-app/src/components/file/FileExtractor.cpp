@@ -18,10 +18,19 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cstring>
+
 #include <QDebug>
 #include <QDir>
 #include <QTimer>
 #include <QProcess>
+#include <QtConcurrent>
+
+#include "config.h"
+
+#ifdef ENABLE_BZIP2
+#include <bzlib.h>
+#endif
 
 #include "FileExtractor.hpp"
 #include "FileDownloader.hpp"
@@ -33,9 +42,207 @@
 
 using namespace std;
 
-FileExtractor::FileExtractor (QObject *parent) : QObject(parent) {}
+#ifdef ENABLE_BZIP2
+namespace {
+	constexpr int BZip2BufferSize = 1024 * 1024;
+	constexpr int ProgressInterval = 100;
+	
+	// Results of the in-process extraction, in addition to the libbz2 codes.
+	constexpr int ExtractionOutputError = 1;
+	constexpr int ExtractionCanceled = 2;
+	
+	struct BZip2Stream {
+		const char *data;
+		unsigned int size;
+		QByteArray output;
+		int result;
+	};
+}
+
+// Offsets of the streams of a multi-stream archive (pbzip2, lbzip2...): a `BZh[1-9]` header
+// followed by the magic of the first block.
+static QVector<qint64> findBZip2Streams (const uchar *data, qint64 size) {
+	static const uchar BlockMagic[] = { 0x31, 0x41, 0x59, 0x26, 0x53, 0x59 };
+	QVector<qint64> streams;
+	for (qint64 i = 0; i + 10 <= size; ++i) {
+		const void *header = memchr(data + i, 'B', size_t(size - 9 - i));
+		if (!header)
+			break;
+		i = static_cast<const uchar *>(header) - data;
+		if (
+			data[i + 1] == 'Z' && data[i + 2] == 'h' && data[i + 3] >= '1' && data[i + 3] <= '9' &&
+			memcmp(data + i + 4, BlockMagic, sizeof BlockMagic) == 0
+		)
+			streams << i;
+	}
+	return streams;
+}
+
+// Decompress one complete stream in memory.
+static int decompressBZip2Stream (BZip2Stream &bzStream) {
+	bz_stream stream = {};
+	int result = BZ2_bzDecompressInit(&stream, 0, 0);
+	if (result != BZ_OK)
+		return result;
+	
+	stream.next_in = const_cast<char *>(bzStream.data);
+	stream.avail_in = bzStream.size;
+	int produced = 0;
+	do {
+		if (produced == bzStream.output.size())
+			bzStream.output.resize(produced + BZip2BufferSize);
+		stream.next_out = bzStream.output.data() + produced;
+		stream.avail_out = unsigned(bzStream.output.size() - produced);
+		result = BZ2_bzDecompress(&stream);
+		produced = bzStream.output.size() - int(stream.avail_out);
+	} while (result == BZ_OK && (stream.avail_in > 0 || stream.avail_out == 0));
+	BZ2_bzDecompressEnd(&stream);
+	bzStream.output.resize(produced);
+	
+	if (result == BZ_STREAM_END)
+		return stream.avail_in == 0 ? BZ_OK : BZ_DATA_ERROR;
+	return result == BZ_OK ? BZ_UNEXPECTED_EOF : result;
+}
+
+// Decompress streams in parallel, by batches of one stream per core, and write them in order.
+static int decompressBZip2Streams (
+	const uchar *data,
+	qint64 size,
+	const QVector<qint64> &streams,
+	QFile &output,
+	std::atomic<qint64> *readBytes,
+	const std::atomic<bool> *canceled
+) {
+	const int batchSize = QThread::idealThreadCount();
+	for (int first = 0; first < streams.size(); first += batchSize) {
+		if (*canceled)
+			return ExtractionCanceled;
+		
+		QVector<BZip2Stream> batch;
+		for (int i = first; i < qMin(first + batchSize, streams.size()); ++i) {
+			const qint64 end = i + 1 < streams.size() ? streams[i + 1] : size;
+			batch << BZip2Stream{ reinterpret_cast<const char *>(data + streams[i]), unsigned(end - streams[i]), QByteArray(), BZ_OK };
+		}
+		QtConcurrent::blockingMap(batch, [readBytes](BZip2Stream &stream) {
+			stream.result = decompressBZip2Stream(stream);
+			*readBytes += stream.size;
+		});
+		
+		for (const BZip2Stream &stream : batch) {
+			if (stream.result != BZ_OK)
+				return stream.result;
+			if (output.write(stream.output) != stream.output.size())
+				return ExtractionOutputError;
+		}
+	}
+	return BZ_OK;
+}
+
+// Decompress sequentially from buffered reads, streams can be concatenated.
+static int decompressBZip2 (QFile &input, QFile &output, std::atomic<qint64> *readBytes, const std::atomic<bool> *canceled) {
+	QByteArray in(BZip2BufferSize, Qt::Uninitialized);
+	QByteArray out(BZip2BufferSize, Qt::Uninitialized);
+	bz_stream stream = {};
+	int result = BZ2_bzDecompressInit(&stream, 0, 0);
+	if (result != BZ_OK)
+		return result;
+	
+	int streamCount = 0;
+	for (;;) {
+		if (*canceled) {
+			result = ExtractionCanceled;
+			break;
+		}
+		if (stream.avail_in == 0) {
+			const qint64 n = input.read(in.data(), in.size());
+			if (n <= 0) {
+				result = n < 0 ? BZ_IO_ERROR : BZ_UNEXPECTED_EOF;
+				break;
+			}
+			stream.next_in = in.data();
+			stream.avail_in = unsigned(n);
+			*readBytes += n;
+		}
+		
+		stream.next_out = out.data();
+		stream.avail_out = unsigned(out.size());
+		result = BZ2_bzDecompress(&stream);
+		const int produced = out.size() - int(stream.avail_out);
+		if (produced > 0 && output.write(out.constData(), produced) != produced) {
+			result = ExtractionOutputError;
+			break;
+		}
+		
+		if (result == BZ_STREAM_END) {
+			++streamCount;
+			if (stream.avail_in == 0 && input.atEnd()) {
+				result = BZ_OK;
+				break;
+			}
+			// Next stream.
+			char *next = stream.next_in;
+			const unsigned int available = stream.avail_in;
+			BZ2_bzDecompressEnd(&stream);
+			stream = bz_stream();
+			if ((result = BZ2_bzDecompressInit(&stream, 0, 0)) != BZ_OK)
+				return result;
+			stream.next_in = next;
+			stream.avail_in = available;
+		} else if (result != BZ_OK) {
+			// Like bzip2, ignore trailing garbage after a stream.
+			if (result == BZ_DATA_ERROR_MAGIC && streamCount > 0)
+				result = BZ_OK;
+			break;
+		}
+	}
+	BZ2_bzDecompressEnd(&stream);
+	return result;
+}
+
+// Run in a worker thread.
+static int extractBZip2 (
+	const QString &file,
+	const QString &destination,
+	std::atomic<qint64> *readBytes,
+	const std::atomic<bool> *canceled
+) {
+	QFile input(file);
+	if (!input.open(QIODevice::ReadOnly))
+		return BZ_IO_ERROR;
+	QFile output(destination);
+	if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return ExtractionOutputError;
+	
+	if (QThread::idealThreadCount() > 1 && input.size() > 0) {
+		if (uchar *data = input.map(0, input.size())) {
+			const QVector<qint64> streams = findBZip2Streams(data, input.size());
+			int result = BZ_DATA_ERROR;
+			if (streams.size() > 1 && streams.first() == 0)
+				result = decompressBZip2Streams(data, input.size(), streams, output, readBytes, canceled);
+			input.unmap(data);
+			if (result == BZ_OK || result == ExtractionOutputError || result == ExtractionCanceled)
+				return result;
+			
+			// Not a multi-stream archive or a header was found in compressed data.
+			*readBytes = 0;
+			if (!output.resize(0) || !output.seek(0))
+				return ExtractionOutputError;
+		}
+	}
+	return decompressBZip2(input, output, readBytes, canceled);
+}
+#endif // ifdef ENABLE_BZIP2
 
-FileExtractor::~FileExtractor () {}
+// -----------------------------------------------------------------------------
+
+FileExtractor::FileExtractor (QObject *parent) : QObject(parent), mExtractedBytes(0), mCancelExtraction(false) {
+	QObject::connect(&mExtractionWatcher, &QFutureWatcher<int>::finished, this, &FileExtractor::handleExtractionFinished);
+}
+
+FileExtractor::~FileExtractor () {
+	mCancelExtraction = true;
+	mExtractionWatcher.waitForFinished();
+}
 
 void FileExtractor::extract () {
 	if (mExtracting) {
@@ -58,7 +265,15 @@ void FileExtractor::extract () {
 		mTimer = new QTimer(this);
 		QObject::connect(mTimer, &QTimer::timeout, this, &FileExtractor::handleExtraction);
 	}
-#ifdef WIN32
+#ifdef ENABLE_BZIP2
+	setTotalBytes(fileInfo.size());
+	setReadBytes(0);
+	mExtractedBytes = 0;
+	mCancelExtraction = false;
+	mTimer->setInterval(ProgressInterval);
+	mTimer->start();
+	mExtractionWatcher.setFuture(QtConcurrent::run(extractBZip2, mFile, mDestinationFile, &mExtractedBytes, &mCancelExtraction));
+#elif defined(WIN32)
 	// Test the presence of bzip2 in the system
 	QProcess process;
 	process.closeReadChannel(QProcess::StandardOutput);
@@ -211,6 +426,12 @@ void FileExtractor::emitOutputError () {
 	emit extractFailed();
 }
 
+#ifdef ENABLE_BZIP2
+// Progress of the in-process extraction.
+void FileExtractor::handleExtraction () {
+	setReadBytes(mExtractedBytes);
+}
+#else
 void FileExtractor::handleExtraction () {
 	QString tempDestination = mDestinationFile+"."+QFileInfo(mFile).suffix();
 	QStringList args;
@@ -236,3 +457,21 @@ void FileExtractor::handleExtraction () {
 	else
 		emitOutputError();
 }
+#endif // ifdef ENABLE_BZIP2
+
+void FileExtractor::handleExtractionFinished () {
+	const int result = mExtractionWatcher.result();
+	if (result == 0) {
+		setReadBytes(getTotalBytes());
+		emitExtractFinished();
+		return;
+	}
+	
+	QFile::remove(mDestinationFile);
+#ifdef ENABLE_BZIP2
+	if (result == ExtractionOutputError)
+		emitOutputError();
+	else
+		emitExtractFailed(result);
+#endif
+}
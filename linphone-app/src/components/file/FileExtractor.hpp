@@ -21,7 +21,10 @@
 #ifndef FILE_EXTRACTOR_H_
 #define FILE_EXTRACTOR_H_
 
+#include <atomic>
+
 #include <QFile>
+#include <QFutureWatcher>
 
 // =============================================================================
 
@@ -87,6 +90,7 @@ private:
   void emitOutputError ();
 
   void handleExtraction ();
+  void handleExtractionFinished ();
 
   QString mFile;
   QString mExtractFolder;
@@ -98,6 +102,11 @@ private:
   qint64 mTotalBytes = 0;
 
   QTimer *mTimer = nullptr;
+
+  // In-process extraction.
+  QFutureWatcher<int> mExtractionWatcher;
+  std::atomic<qint64> mExtractedBytes;
+  std::atomic<bool> mCancelExtraction;
 };
 
 #endif // FILE_EXTRACTOR_H_
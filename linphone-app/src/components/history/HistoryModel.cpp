@@ -34,6 +34,7 @@
 #include "app/App.hpp"
 #include "app/paths/Paths.hpp"
 #include "app/providers/ThumbnailProvider.hpp"
+#include "app/tracer/Tracer.hpp"
 #include "components/core/CoreHandlers.hpp"
 #include "components/core/CoreManager.hpp"
 #include "components/notifier/Notifier.hpp"
@@ -68,6 +69,7 @@ static inline void fillCallEndEntry (QVariantMap &dest, const shared_ptr<linphon
 // -----------------------------------------------------------------------------
 
 HistoryModel::HistoryModel (QObject *parent) :QAbstractListModel(parent){
+	Tracer::Span span("HistoryModel::HistoryModel");
 	CoreManager *coreManager = CoreManager::getInstance();
 	
 	mCoreHandlers = coreManager->getHandlers();
@@ -139,6 +141,7 @@ bool HistoryModel::removeRows (int row, int count, const QModelIndex &parent) {
 }
 
 void HistoryModel::setSipAddresses () {
+	Tracer::Span span("HistoryModel::setSipAddresses");
 	shared_ptr<linphone::Core> core = CoreManager::getInstance()->getCore();
 	mEntries.clear();
 	
@@ -227,7 +230,6 @@ void HistoryModel::insertCall (const shared_ptr<linphone::CallLog> &callLog) {
 		beginInsertRows(QModelIndex(), row, row);
 		it = mEntries.insert(it, entry);
 		endInsertRows();
-		emit layoutChanged();
 		
 		return it;
 	};
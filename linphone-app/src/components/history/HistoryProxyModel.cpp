@@ -21,6 +21,7 @@
 #include <QQuickWindow>
 
 #include "app/App.hpp"
+#include "app/tracer/ModelStats.hpp"
 #include "components/core/CoreManager.hpp"
 
 #include "HistoryProxyModel.hpp"
@@ -46,6 +47,7 @@ public:
 	
 protected:
 	bool filterAcceptsRow (int sourceRow, const QModelIndex &) const override {
+		ModelStats::Scope scope(this, ModelStats::FilterTiming);
 		if (mEntryTypeFilter == HistoryModel::EntryType::GenericEntry)
 			return true;
 		
@@ -62,8 +64,13 @@ private:
 // =============================================================================
 
 HistoryProxyModel::HistoryProxyModel (QObject *parent) : QSortFilterProxyModel(parent) {
+	ModelStats::watch(this);
 	
 	setSourceModel(new HistoryModelFilter(this));
+	// Keep displayed entries when new ones are inserted : the window of the last entries grows with them and rows don't need to be filtered again.
+	QObject::connect(sourceModel(), &QAbstractItemModel::rowsAboutToBeInserted, this, [this](const QModelIndex &, int first, int last) {
+		mMaxDisplayedEntries += last - first + 1;
+	});
 	reload();
 	
 	App *app = App::getInstance();
@@ -71,7 +78,7 @@ HistoryProxyModel::HistoryProxyModel (QObject *parent) : QSortFilterProxyModel(p
 		handleIsActiveChanged(App::getInstance()->getMainWindow());
 	});
 	
-	QQuickWindow *callsWindow = app->getCallsWindow();
+	QQuickWindow *callsWindow = app->getCallsWindowIfCreated();
 	if (callsWindow)
 		QObject::connect(callsWindow, &QWindow::activeChanged, this, [this, callsWindow]() {
 			handleIsActiveChanged(callsWindow);
@@ -102,7 +109,7 @@ void HistoryProxyModel::loadMoreEntries () {
 	if (count < parentCount) {
 		// Do not increase `mMaxDisplayedEntries` if it's not necessary...
 		// Limit qml calls.
-		if (count == mMaxDisplayedEntries)
+		if (count >= mMaxDisplayedEntries)
 			mMaxDisplayedEntries += EntriesChunkSize;
 		
 		invalidateFilter();
@@ -125,6 +132,7 @@ void HistoryProxyModel::setEntryTypeFilter (HistoryModel::EntryType type) {
 // -----------------------------------------------------------------------------
 
 bool HistoryProxyModel::filterAcceptsRow (int sourceRow, const QModelIndex &) const {
+	ModelStats::Scope scope(this, ModelStats::FilterTiming);
 	return sourceModel()->rowCount() - sourceRow <= mMaxDisplayedEntries;
 }
 
@@ -145,7 +153,7 @@ void HistoryProxyModel::resetMessageCount(){
 static inline QWindow *getParentWindow (QObject *object) {
 	App *app = App::getInstance();
 	const QWindow *mainWindow = app->getMainWindow();
-	const QWindow *callsWindow = app->getCallsWindow();
+	const QWindow *callsWindow = app->getCallsWindowIfCreated();
 	for (QObject *parent = object->parent(); parent; parent = parent->parent())
 		if (parent == mainWindow || parent == callsWindow)
 			return static_cast<QWindow *>(parent);
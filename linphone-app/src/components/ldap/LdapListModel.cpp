@@ -23,6 +23,7 @@
 #include <QUrl>
 #include <QtDebug>
 
+#include "app/tracer/Tracer.hpp"
 #include "components/core/CoreHandlers.hpp"
 #include "components/core/CoreManager.hpp"
 #include "utils/Utils.hpp"
@@ -34,6 +35,7 @@
 using namespace std;
 
 LdapListModel::LdapListModel (QObject *parent) : ProxyListModel(parent) {
+  Tracer::Span span("LdapListModel::LdapListModel");
   initLdap();
 }
 
@@ -18,6 +18,7 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <QMutex>
 #include <QQmlApplicationEngine>
 #include <QQmlComponent>
 #include <QQuickWindow>
@@ -25,6 +26,7 @@
 #include <QQuickView>
 #include <QScreen>
 #include <QTimer>
+#include <QVector>
 
 #include "app/App.hpp"
 #include "components/call/CallModel.hpp"
@@ -57,6 +59,10 @@ namespace {
 
   constexpr char NotificationPropertyTimer[] = "__timer";
 
+  constexpr char NotificationPropertyValid[] = "__valid";
+
+  constexpr char NotificationPropertyShowAsTool[] = "showAsTool";
+
   // ---------------------------------------------------------------------------
   // Arbitrary hardcoded values.
   // ---------------------------------------------------------------------------
@@ -107,11 +113,29 @@ Notifier::Notifier (QObject *parent) : QObject(parent) {
   }
 
   mMutex = new QMutex();
+
+  mPoolSize = MaxNotificationsNumber;
+  QObject::connect(qApp, &QGuiApplication::screenRemoved, this, &Notifier::handleScreenRemoved);
+  QObject::connect(CoreManager::getInstance(), &CoreManager::coreManagerInitialized, this, [this] {
+    SettingsModel *settingsModel = CoreManager::getInstance()->getSettingsModel();
+    mPoolSize = qMax(0, settingsModel->getNotificationsPoolSize());
+    QTimer::singleShot(0, this, &Notifier::warmUp);
+  });
+
+  mMessageBurstTimer = new QTimer(this);
+  mMessageBurstTimer->setSingleShot(true);
+  QObject::connect(mMessageBurstTimer, &QTimer::timeout, this, &Notifier::flushMessageBursts);
 }
 
 Notifier::~Notifier () {
   delete mMutex;
 
+  for (auto &views : mViewsPool)
+    for (auto &view : views)
+      if (view)
+        view->deleteLater();
+  mViewsPool.clear();
+
   const int nComponents = Notifications.size();
   for (int i = 0; i < nComponents; ++i)
     mComponents[i]->deleteLater();
@@ -120,6 +144,90 @@ Notifier::~Notifier () {
 
 // -----------------------------------------------------------------------------
 
+QQuickView *Notifier::createView (NotificationType type, QScreen *screen) {
+	QQuickView *view = new QQuickView(App::getInstance()->getEngine(), nullptr);	// Use QQuickView to create a visual root object that is independant from current application Window
+	QObject::connect(view, &QQuickView::statusChanged, [](QQuickView::Status status){	// Debug handler : show screens descriptions on Error
+		if( status == QQuickView::Error){
+			QScreen * primaryScreen = QGuiApplication::primaryScreen();
+			qInfo() << "Primary screen : " << primaryScreen->geometry() << primaryScreen->availableGeometry() <<  primaryScreen->virtualGeometry() <<  primaryScreen->availableVirtualGeometry();
+			QList<QScreen *> allScreens = QGuiApplication::screens();
+			for(int i = 0 ; i < allScreens.size() ; ++i){
+				QScreen *screen = allScreens[i];
+				qInfo() << QString("Screen [")+QString::number(i)+"] (hdpi, Geometry, Available, Virtual, AvailableGeometry) :" 
+					<< screen->devicePixelRatio() << screen->geometry() << screen->availableGeometry() << screen->virtualGeometry() << screen->availableVirtualGeometry();
+			}
+		}
+	});
+	view->setScreen(screen);	// Bind the visual root object to the screen
+	view->setProperty("flags", QVariant(Qt::BypassWindowManagerHint | Qt::WindowStaysOnBottomHint | Qt::CustomizeWindowHint | Qt::X11BypassWindowManagerHint));	// Set the visual ghost window
+	view->setSource(QString(NotificationsPath)+Notifier::Notifications[type].filename);
+
+	QQuickWindow *subWindow = view->findChild<QQuickWindow *>(NotificationPropertyWindow);
+	if (!subWindow) {
+		view->deleteLater();
+		return nullptr;
+	}
+	QObject::connect(subWindow, &QObject::destroyed, view, &QObject::deleteLater);	// When destroying window, detroy visual root object too
+	subWindow->hide();	// The popup window is visible on creation : keep it hidden until the notification is shown.
+	return view;
+}
+
+QQuickView *Notifier::takeView (NotificationType type, QScreen *screen) {
+	QList<QPointer<QQuickView>> &views = mViewsPool[qMakePair(screen->name(), int(type))];
+	while (!views.isEmpty()) {
+		QPointer<QQuickView> view = views.takeLast();
+		if (view && view->screen() == screen)
+			return view;
+		else if (view)
+			view->deleteLater();
+	}
+	return createView(type, screen);
+}
+
+void Notifier::releaseView (NotificationType type, const QString &screenName, QQuickView *view) {
+	QList<QPointer<QQuickView>> &views = mViewsPool[qMakePair(screenName, int(type))];
+	if (views.size() < mPoolSize)
+		views << view;
+	else
+		view->deleteLater();
+}
+
+void Notifier::warmUp () {
+	SettingsModel *settingsModel = CoreManager::getInstance()->getSettingsModel();
+	const int count = qMin(settingsModel->getNotificationsPoolWarmUp(), mPoolSize);
+	if (count <= 0)
+		return;
+	QMutexLocker locker(mMutex);
+	for (QScreen *screen : QGuiApplication::screens())
+		for (NotificationType type : { ReceivedMessage, ReceivedCall }) {
+			QList<QPointer<QQuickView>> &views = mViewsPool[qMakePair(screen->name(), int(type))];
+			while (views.size() < count) {
+				QQuickView *view = createView(type, screen);
+				if (!view)
+					break;
+				views << view;
+			}
+		}
+	qInfo() << QStringLiteral("Notification views warmed up:") << count;
+}
+
+void Notifier::handleScreenRemoved (QScreen *screen) {
+	QMutexLocker locker(mMutex);
+	const QString screenName = screen->name();
+	for (auto it = mViewsPool.begin(); it != mViewsPool.end(); ) {
+		if (it.key().first == screenName) {
+			for (auto &view : it.value())
+				if (view)
+					view->deleteLater();
+			it = mViewsPool.erase(it);
+		} else
+			++it;
+	}
+	mScreenHeightOffset.remove(screenName);
+}
+
+// -----------------------------------------------------------------------------
+
 QObject *Notifier::createNotification (Notifier::NotificationType type, QVariantMap data) {
 	QQuickItem *wrapperItem = nullptr;
 	mMutex->lock();
@@ -132,7 +240,8 @@ QObject *Notifier::createNotification (Notifier::NotificationType type, QVariant
 	QList<QScreen *> allScreens = QGuiApplication::screens();
 	if(allScreens.size() > 0){	// Ensure to have a screen to avoid errors
 		QQuickItem * previousWrapper = nullptr;
-		++mInstancesNumber;
+		DisplayedNotification displayed;
+		displayed.type = type;
 		bool showAsTool = false;
 #ifdef Q_OS_MACOS
 		for(auto w : QGuiApplication::topLevelWindows()){
@@ -143,31 +252,18 @@ QObject *Notifier::createNotification (Notifier::NotificationType type, QVariant
 		}
 #endif
 		for(int i = 0 ; i < allScreens.size() ; ++i){
-			QQuickView *view = new QQuickView(App::getInstance()->getEngine(), nullptr);	// Use QQuickView to create a visual root object that is independant from current application Window
 			QScreen *screen = allScreens[i];
-			QObject::connect(view, &QQuickView::statusChanged, [allScreens](QQuickView::Status status){	// Debug handler : show screens descriptions on Error
-				if( status == QQuickView::Error){
-					QScreen * primaryScreen = QGuiApplication::primaryScreen();
-					qInfo() << "Primary screen : " << primaryScreen->geometry() << primaryScreen->availableGeometry() <<  primaryScreen->virtualGeometry() <<  primaryScreen->availableVirtualGeometry();
-					for(int i = 0 ; i < allScreens.size() ; ++i){
-						QScreen *screen = allScreens[i];
-						qInfo() << QString("Screen [")+QString::number(i)+"] (hdpi, Geometry, Available, Virtual, AvailableGeometry) :" 
-							<< screen->devicePixelRatio() << screen->geometry() << screen->availableGeometry() << screen->virtualGeometry() << screen->availableVirtualGeometry();
-					}
-				}
-			});
-			view->setScreen(screen);	// Bind the visual root object to the screen
-			view->setProperty("flags", QVariant(Qt::BypassWindowManagerHint | Qt::WindowStaysOnBottomHint | Qt::CustomizeWindowHint | Qt::X11BypassWindowManagerHint));	// Set the visual ghost window
-			view->setSource(QString(NotificationsPath)+Notifier::Notifications[type].filename);
-
-			QQuickWindow *subWindow = view->findChild<QQuickWindow *>("__internalWindow");
-			QObject::connect(subWindow, &QObject::destroyed, view, &QObject::deleteLater);	// When destroying window, detroy visual root object too
+			QQuickView *view = takeView(type, screen);
+			if (!view)
+				continue;
+			QQuickWindow *subWindow = view->findChild<QQuickWindow *>(NotificationPropertyWindow);
+			wrapperItem = view->findChild<QQuickItem *>("__internalWrapper");
+			::setProperty(*wrapperItem, NotificationPropertyData,data);	// Set data first : the popup size depends on its content.
+			subWindow->setProperty(NotificationPropertyShowAsTool, showAsTool);
 
 			int * screenHeightOffset = &mScreenHeightOffset[screen->name()];	// Access optimization
 			QRect availableGeometry = screen->availableGeometry();
 			int heightOffset = availableGeometry.y() + (availableGeometry.height() - subWindow->height());//*screen->devicePixelRatio(); when using manual scaler
-			if(showAsTool)
-				subWindow->setProperty("showAsTool",true);
 			subWindow->setX(availableGeometry.x()+ (availableGeometry.width()-subWindow->property("width").toInt()));//*screen->devicePixelRatio()); when using manual scaler
 			subWindow->setY(heightOffset-(*screenHeightOffset % heightOffset));
 
@@ -179,19 +275,22 @@ QObject *Notifier::createNotification (Notifier::NotificationType type, QVariant
 //				//subwindow->setProperty("xScale", (double)screen->availableVirtualGeometry().width()/availableGeometry.width() );
 //				//subwindow->setProperty("yScale", (double)screen->availableVirtualGeometry().height()/availableGeometry.height());
 //			}
-			wrapperItem = view->findChild<QQuickItem *>("__internalWrapper");
-			::setProperty(*wrapperItem, NotificationPropertyData,data);
 			view->setGeometry(subWindow->geometry());	// Ensure to have sufficient space to both let painter do job without error, and stay behind popup
 
 			if(previousWrapper!=nullptr){	// Link objects in order to propagate events without having to store them
 				QObject::connect(previousWrapper, SIGNAL(deleteNotification(QVariant)), wrapperItem,SLOT(deleteNotificationSlot()));
 				QObject::connect(wrapperItem, SIGNAL(isOpened()), previousWrapper,SLOT(open()));
 				QObject::connect(wrapperItem, SIGNAL(isClosed()), previousWrapper,SLOT(close()));
-				QObject::connect(wrapperItem, &QObject::destroyed, previousWrapper, &QObject::deleteLater);
 			}
 			previousWrapper = wrapperItem;	// The last one is used as a point of start when deleting and openning
+			displayed.views << qMakePair(screen->name(), QPointer<QQuickView>(view));
 
 			view->show();
+			subWindow->show();
+		}
+		if (wrapperItem) {
+			++mInstancesNumber;
+			mDisplayedNotifications[wrapperItem] = displayed;
 		}
 		qInfo() << QStringLiteral("Create notifications:") << wrapperItem;
 	}
@@ -240,15 +339,17 @@ void Notifier::deleteNotification (QVariant notification) {
   QObject *instance = notification.value<QObject *>();
 
   // Notification marked destroyed.
-  if (instance->property("__valid").isValid()) {
+  if (instance->property(NotificationPropertyValid).isValid() || !mDisplayedNotifications.contains(instance)) {
     mMutex->unlock();
     return;
   }
 
   qInfo() << QStringLiteral("Delete notification:") << instance;
 
-  instance->setProperty("__valid", true);
-  instance->property(NotificationPropertyTimer).value<QTimer *>()->stop();
+  instance->setProperty(NotificationPropertyValid, true);
+  QTimer *timer = instance->property(NotificationPropertyTimer).value<QTimer *>();
+  if (timer)
+    timer->stop();
 
   mInstancesNumber--;
   Q_ASSERT(mInstancesNumber >= 0);
@@ -256,9 +357,42 @@ void Notifier::deleteNotification (QVariant notification) {
   if (mInstancesNumber == 0)
 	mScreenHeightOffset.clear();
 
+  const DisplayedNotification displayed = mDisplayedNotifications.take(instance);
+
   mMutex->unlock();
 
-  instance->deleteLater();
+  // Close the popups and give their views back to the pool.
+  QMetaObject::invokeMethod(instance, "close", Qt::DirectConnection);
+  QVector<QQuickItem *> wrappers;
+  for (const auto &screenView : displayed.views)
+    wrappers << (screenView.second ? screenView.second->findChild<QQuickItem *>("__internalWrapper") : nullptr);
+  for (int i = 1; i < wrappers.size(); ++i) {
+    QQuickItem *previousWrapper = wrappers[i - 1];
+    QQuickItem *wrapperItem = wrappers[i];
+    if (!previousWrapper || !wrapperItem)
+      continue;
+    QObject::disconnect(previousWrapper, SIGNAL(deleteNotification(QVariant)), wrapperItem, SLOT(deleteNotificationSlot()));
+    QObject::disconnect(wrapperItem, SIGNAL(isOpened()), previousWrapper, SLOT(open()));
+    QObject::disconnect(wrapperItem, SIGNAL(isClosed()), previousWrapper, SLOT(close()));
+  }
+  QObject::disconnect(instance, nullptr, this, nullptr);
+  if (timer)
+    timer->deleteLater();	// Also drops the connections using it as context.
+  instance->setProperty(NotificationPropertyTimer, QVariant());
+  instance->setProperty(NotificationPropertyValid, QVariant());
+
+  QMutexLocker locker(mMutex);
+  for (int i = 0; i < displayed.views.size(); ++i) {
+    QQuickView *view = displayed.views[i].second;
+    if (!view)
+      continue;
+    // Keep the data until the next use : it is replaced before the view is shown again.
+    view->hide();
+    QQuickWindow *subWindow = view->findChild<QQuickWindow *>(NotificationPropertyWindow);
+    if (subWindow)
+      subWindow->hide();
+    releaseView(displayed.type, displayed.views[i].first, view);
+  }
 }
 
 // =============================================================================
@@ -275,7 +409,98 @@ void Notifier::deleteNotification (QVariant notification) {
 // -----------------------------------------------------------------------------
 
 void Notifier::notifyReceivedMessage (const shared_ptr<linphone::ChatMessage> &message) {
+  if (!aggregateReceivedMessage(message, nullptr))
+    showReceivedMessage(message);
+}
+
+void Notifier::notifyReceivedFileMessage (const shared_ptr<linphone::ChatMessage> &message, const shared_ptr<linphone::Content> &content) {
+  if (!aggregateReceivedMessage(message, content))
+    showReceivedFileMessage(message, content);
+}
+
+// -----------------------------------------------------------------------------
+// Received messages aggregation.
+// -----------------------------------------------------------------------------
+
+bool Notifier::aggregateReceivedMessage (const shared_ptr<linphone::ChatMessage> &message, const shared_ptr<linphone::Content> &content) {
+  const int burstDelay = CoreManager::getInstance()->getSettingsModel()->getNotificationsBurstDelay();
+  if (burstDelay <= 0)
+    return false;
+
+  shared_ptr<linphone::ChatRoom> chatRoom = message->getChatRoom();
+  if (!chatRoom)
+    return false;
+
+  const ChatRoomKey key = getChatRoomKey(chatRoom);
+  auto it = mMessageBursts.find(key);
+  if (it == mMessageBursts.end()) {	// Open a window and let the caller show this message now.
+    MessageBurst &burst = mMessageBursts[key];
+    burst.lastMessage = message;
+    mMessageBurstsOrder << key;
+    if (!mMessageBurstTimer->isActive())
+      mMessageBurstTimer->start(burstDelay);
+    return false;
+  }
+
+  MessageBurst &burst = *it;
+  // A downloaded file belongs to a message that may have already been counted.
+  if (!content || burst.lastMessage != message || burst.count == 0)
+    ++burst.count;
+  burst.lastMessage = message;
+  burst.lastContent = content;
+  return true;
+}
+
+Notifier::ChatRoomKey Notifier::getChatRoomKey (const shared_ptr<linphone::ChatRoom> &chatRoom) {
+  shared_ptr<const linphone::Address> peerAddress = chatRoom->getPeerAddress();
+  shared_ptr<const linphone::Address> localAddress = chatRoom->getLocalAddress();
+  return ChatRoomKey(
+    peerAddress ? Utils::coreStringToAppString(peerAddress->asStringUriOnly()) : QString(),
+    localAddress ? Utils::coreStringToAppString(localAddress->asStringUriOnly()) : QString()
+  );
+}
+
+void Notifier::flushMessageBursts () {
+  const QHash<ChatRoomKey, MessageBurst> bursts = mMessageBursts;
+  const QList<ChatRoomKey> order = mMessageBurstsOrder;
+  mMessageBursts.clear();
+  mMessageBurstsOrder.clear();
+
+  for (const ChatRoomKey &key : order) {
+    const MessageBurst &burst = bursts[key];
+    if (burst.count == 0)	// Quiet chat room : the next message is shown at once.
+      continue;
+    if (burst.count > 1)
+      showReceivedMessages(burst.lastMessage, burst.count);
+    else if (burst.lastContent)
+      showReceivedFileMessage(burst.lastMessage, burst.lastContent);
+    else
+      showReceivedMessage(burst.lastMessage);
+    // Still busy : keep coalescing during a new window.
+    mMessageBursts[key].lastMessage = burst.lastMessage;
+    mMessageBurstsOrder << key;
+  }
+
+  if (!mMessageBursts.isEmpty())
+    mMessageBurstTimer->start(CoreManager::getInstance()->getSettingsModel()->getNotificationsBurstDelay());
+}
+
+QVariantMap Notifier::createReceivedMessageData (const shared_ptr<linphone::ChatMessage> &message) const {
   QVariantMap map;
+  shared_ptr<linphone::ChatRoom> chatRoom(message->getChatRoom());
+  map["timelineModel"].setValue(CoreManager::getInstance()->getTimelineListModel()->getTimeline(chatRoom, true).get());
+  map["peerAddress"] = Utils::coreStringToAppString(message->getFromAddress()->asStringUriOnly());
+  map["localAddress"] = Utils::coreStringToAppString(message->getToAddress()->asStringUriOnly());
+  map["fullPeerAddress"] = Utils::coreStringToAppString(message->getFromAddress()->asString());
+  map["fullLocalAddress"] = Utils::coreStringToAppString(message->getToAddress()->asString());
+  map["window"].setValue(App::getInstance()->getMainWindow());
+  return map;
+}
+
+// -----------------------------------------------------------------------------
+
+void Notifier::showReceivedMessage (const shared_ptr<linphone::ChatMessage> &message) {
+  QVariantMap map = createReceivedMessageData(message);
   QString txt;
   if(! message->getFileTransferInformation() ){
 	  foreach(auto content, message->getContents()){
@@ -285,17 +510,10 @@ void Notifier::notifyReceivedMessage (const shared_ptr<linphone::ChatMessage> &m
   }else
 	  txt = tr("newFileMessage");
   map["message"] = txt;
-  shared_ptr<linphone::ChatRoom> chatRoom(message->getChatRoom());
-  map["timelineModel"].setValue(CoreManager::getInstance()->getTimelineListModel()->getTimeline(chatRoom, true).get());
-  map["peerAddress"] = Utils::coreStringToAppString(message->getFromAddress()->asStringUriOnly());
-  map["localAddress"] = Utils::coreStringToAppString(message->getToAddress()->asStringUriOnly());
-  map["fullPeerAddress"] = Utils::coreStringToAppString(message->getFromAddress()->asString());
-  map["fullLocalAddress"] = Utils::coreStringToAppString(message->getToAddress()->asString());
-  map["window"].setValue(App::getInstance()->getMainWindow());
   CREATE_NOTIFICATION(Notifier::ReceivedMessage, map)
 }
 
-void Notifier::notifyReceivedFileMessage (const shared_ptr<linphone::ChatMessage> &message, const shared_ptr<linphone::Content> &content) {
+void Notifier::showReceivedFileMessage (const shared_ptr<linphone::ChatMessage> &message, const shared_ptr<linphone::Content> &content) {
   QVariantMap map;
   shared_ptr<linphone::ChatRoom> chatRoom(message->getChatRoom());
   map["timelineModel"].setValue(CoreManager::getInstance()->getTimelineListModel()->getTimeline(chatRoom, true).get());
@@ -308,13 +526,23 @@ void Notifier::notifyReceivedFileMessage (const shared_ptr<linphone::ChatMessage
   CREATE_NOTIFICATION(Notifier::ReceivedFileMessage, map)
 }
 
+void Notifier::showReceivedMessages (const shared_ptr<linphone::ChatMessage> &lastMessage, int count) {
+  QVariantMap map = createReceivedMessageData(lastMessage);
+  TimelineModel *timelineModel = map["timelineModel"].value<TimelineModel *>();
+  const QString name = timelineModel ? timelineModel->getUsername() : map["peerAddress"].toString();
+  map["message"] = tr("newMessagesSummary", "", count).arg(name);
+  CREATE_NOTIFICATION(Notifier::ReceivedMessage, map)
+}
+
 void Notifier::notifyReceivedCall (const shared_ptr<linphone::Call> &call) {
   CallModel *callModel = &call->getData<CallModel>("call-model");
   QVariantMap map;
   map["call"].setValue(callModel);
   CREATE_NOTIFICATION(Notifier::ReceivedCall, map)
 
-  QObject::connect(callModel, &CallModel::statusChanged, notification, [this, notification](CallModel::CallStatus status) {
+  // The timer lives as long as this display of the notification : the view is recycled afterwards.
+  QTimer *timer = notification->property(NotificationPropertyTimer).value<QTimer *>();
+  QObject::connect(callModel, &CallModel::statusChanged, timer, [this, notification](CallModel::CallStatus status) {
       if (status == CallModel::CallStatusEnded || status == CallModel::CallStatusConnected)
         deleteNotification(QVariant::fromValue(notification));
     });
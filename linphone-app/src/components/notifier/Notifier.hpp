@@ -25,6 +25,7 @@
 
 #include <QObject>
 #include <QHash>
+#include <QPointer>
 
 #include "components/core/CoreManager.hpp"
 #include "components/settings/SettingsModel.hpp"
@@ -32,10 +33,15 @@
 
 class QMutex;
 class QQmlComponent;
+class QQuickView;
+class QScreen;
+class QTimer;
 
 namespace linphone {
 class Call;
 class ChatMessage;
+class ChatRoom;
+class Content;
 }
 
 class Notifier : public QObject {
@@ -84,11 +90,48 @@ private:
 		int type;
 	};
 	
+	// Views of a displayed notification, one per screen.
+	struct DisplayedNotification {
+		NotificationType type = ReceivedMessage;
+		QList<QPair<QString, QPointer<QQuickView>>> views;	// Screen name and its view.
+	};
+	
 	QObject *createNotification (NotificationType type, QVariantMap data);
 	void showNotification (QObject *notification, int timeout);
 	
+	// Views are recycled instead of being compiled and instantiated for each notification.
+	QQuickView *createView (NotificationType type, QScreen *screen);
+	QQuickView *takeView (NotificationType type, QScreen *screen);
+	void releaseView (NotificationType type, const QString &screenName, QQuickView *view);
+	void warmUp ();
+	void handleScreenRemoved (QScreen *screen);
+	
+	// The first message of a chat room is shown at once, the next ones received during the burst window are shown as one notification.
+	struct MessageBurst {
+		std::shared_ptr<linphone::ChatMessage> lastMessage;
+		std::shared_ptr<linphone::Content> lastContent;	// Set if the last notified message is a downloaded file.
+		int count = 0;	// Messages waiting for the end of the window.
+	};
+	
+	bool aggregateReceivedMessage (const std::shared_ptr<linphone::ChatMessage> &message, const std::shared_ptr<linphone::Content> &content);
+	void flushMessageBursts ();
+	QVariantMap createReceivedMessageData (const std::shared_ptr<linphone::ChatMessage> &message) const;
+	void showReceivedMessage (const std::shared_ptr<linphone::ChatMessage> &message);
+	void showReceivedFileMessage (const std::shared_ptr<linphone::ChatMessage> &message, const std::shared_ptr<linphone::Content> &content);
+	void showReceivedMessages (const std::shared_ptr<linphone::ChatMessage> &lastMessage, int count);
+	
 	QHash<QString,int> mScreenHeightOffset;
 	int mInstancesNumber = 0;
+	int mPoolSize;
+	
+	QHash<QPair<QString, int>, QList<QPointer<QQuickView>>> mViewsPool;
+	QHash<QObject *, DisplayedNotification> mDisplayedNotifications;
+	
+	typedef QPair<QString, QString> ChatRoomKey;	// Peer and local addresses : a chat room may be destroyed during the window.
+	static ChatRoomKey getChatRoomKey (const std::shared_ptr<linphone::ChatRoom> &chatRoom);
+	QHash<ChatRoomKey, MessageBurst> mMessageBursts;
+	QList<ChatRoomKey> mMessageBurstsOrder;	// Keep the arrival order of chat rooms.
+	QTimer *mMessageBurstTimer = nullptr;
 	
 	QMutex *mMutex = nullptr;
 	QQmlComponent **mComponents = nullptr;
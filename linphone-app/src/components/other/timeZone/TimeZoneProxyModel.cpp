@@ -18,6 +18,7 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "app/tracer/ModelStats.hpp"
 #include "components/core/CoreManager.hpp"
 
 #include "TimeZoneModel.hpp"
@@ -34,6 +35,7 @@ TimeZoneProxyModel::TimeZoneProxyModel (QObject *parent) : SortFilterProxyModel(
 // -----------------------------------------------------------------------------
 
 bool TimeZoneProxyModel::lessThan (const QModelIndex &left, const QModelIndex &right) const {
+	ModelStats::Scope scope(this, ModelStats::SortTiming);
 	auto test = sourceModel()->data(left);
 	const TimeZoneModel* a = sourceModel()->data(left).value<TimeZoneModel*>();
 	const TimeZoneModel* b = sourceModel()->data(right).value<TimeZoneModel*>();
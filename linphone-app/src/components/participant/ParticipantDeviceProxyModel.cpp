@@ -21,6 +21,7 @@
 #include <QQmlApplicationEngine>
 
 #include "app/App.hpp"
+#include "app/tracer/ModelStats.hpp"
 
 #include "ParticipantDeviceProxyModel.hpp"
 #include "utils/Utils.hpp"
@@ -37,6 +38,7 @@ bool ParticipantDeviceProxyModel::filterAcceptsRow (
   int sourceRow,
   const QModelIndex &sourceParent
 ) const {
+	ModelStats::Scope scope(this, ModelStats::FilterTiming);
 	Q_UNUSED(sourceRow)
 	Q_UNUSED(sourceParent)
 	auto listModel = qobject_cast<ParticipantDeviceListModel*>(sourceModel());
@@ -46,6 +48,7 @@ bool ParticipantDeviceProxyModel::filterAcceptsRow (
 }
 
 bool ParticipantDeviceProxyModel::lessThan (const QModelIndex &left, const QModelIndex &right) const {
+	ModelStats::Scope scope(this, ModelStats::SortTiming);
   const ParticipantDeviceModel *deviceA = sourceModel()->data(left).value<ParticipantDeviceModel *>();
   const ParticipantDeviceModel *deviceB = sourceModel()->data(right).value<ParticipantDeviceModel *>();
 
@@ -179,11 +179,12 @@ void ParticipantListModel::updateParticipants () {
 				changed = true;
 			}else if(!itParticipant->objectCast<ParticipantModel>()->getParticipant() || itParticipant->objectCast<ParticipantModel>()->getParticipant() != dbParticipant){
 				itParticipant->objectCast<ParticipantModel>()->setParticipant(dbParticipant);
+				QModelIndex modelIndex = index(int(itParticipant - mList.begin()), 0);
+				emit dataChanged(modelIndex, modelIndex);
 				changed = true;
 			}
 		}
 		if( changed){
-			emit layoutChanged();
 			emit participantsChanged();
 			emit countChanged();
 		}
@@ -196,7 +197,6 @@ void ParticipantListModel::add (QSharedPointer<ParticipantModel> participant){
 	connect(this, &ParticipantListModel::securityLevelChanged, participant.get(), &ParticipantModel::onSecurityLevelChanged);
 	connect(participant.get(),&ParticipantModel::updateAdminStatus, this, &ParticipantListModel::setAdminStatus);
 	ProxyListModel::add(participant);
-	emit layoutChanged();
 	emit participantsChanged();
 }
 
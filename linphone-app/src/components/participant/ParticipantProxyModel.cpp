@@ -20,6 +20,7 @@
 
 #include "ParticipantProxyModel.hpp"
 
+#include "app/tracer/ModelStats.hpp"
 #include "components/core/CoreManager.hpp"
 #include "components/settings/AccountSettingsModel.hpp"
 #include "components/sip-addresses/SipAddressesModel.hpp"
@@ -38,6 +39,7 @@
 // -----------------------------------------------------------------------------
 
 ParticipantProxyModel::ParticipantProxyModel (QObject *parent) : QSortFilterProxyModel(parent) {
+	ModelStats::watch(this);
 	setSourceModel(new ParticipantListModel((ConferenceModel*)nullptr, this));
 }
 
@@ -175,6 +177,7 @@ void ParticipantProxyModel::removeModel(ParticipantModel * participant){
 // -----------------------------------------------------------------------------
 
 bool ParticipantProxyModel::filterAcceptsRow (int sourceRow, const QModelIndex &sourceParent) const {
+	ModelStats::Scope scope(this, ModelStats::FilterTiming);
 	if( mShowMe)
 		return true;
 	else{
@@ -184,6 +187,7 @@ bool ParticipantProxyModel::filterAcceptsRow (int sourceRow, const QModelIndex &
 }
 
 bool ParticipantProxyModel::lessThan (const QModelIndex &left, const QModelIndex &right) const {
+	ModelStats::Scope scope(this, ModelStats::SortTiming);
 	const ParticipantModel* a = sourceModel()->data(left).value<ParticipantModel*>();
 	const ParticipantModel* b = sourceModel()->data(right).value<ParticipantModel*>();
 	
@@ -0,0 +1,452 @@
+/*
+ * Copyright (c) 2022 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QtDebug>
+
+#include "app/paths/Paths.hpp"
+#include "components/core/CoreManager.hpp"
+#include "utils/Utils.hpp"
+
+#include "MessageSearchIndex.hpp"
+
+// =============================================================================
+
+namespace {
+	constexpr char ConnectionName[] = "message-search-index";
+	constexpr int BackfillBatchSize = 20;
+	constexpr int BackfillInterval = 50;	// In ms.
+	constexpr int BackfillTimeBudget = 4;	// In ms, by interval.
+	
+	QString getPeerAddress (const std::shared_ptr<linphone::ChatRoom> &chatRoom) {
+		auto peerAddress = chatRoom->getPeerAddress();
+		return peerAddress ? Utils::coreStringToAppString(peerAddress->asStringUriOnly()) : QString();
+	}
+	
+	// Same as `ChatRoomModel::getLocalAddress`.
+	QString getLocalAddress (const std::shared_ptr<linphone::ChatRoom> &chatRoom) {
+		auto localAddress = chatRoom->getLocalAddress();
+		if (!localAddress)
+			return QString();
+		localAddress = localAddress->clone();
+		localAddress->clean();
+		return Utils::coreStringToAppString(localAddress->asStringUriOnly());
+	}
+}
+
+constexpr int MessageSearchIndex::DefaultLimit;
+
+MessageSearchIndex *MessageSearchIndex::mInstance = nullptr;
+
+// -----------------------------------------------------------------------------
+
+MessageSearchIndex::MessageSearchIndex (QObject *parent) : QObject(parent) {
+	mWorker = new QObject();
+	mWorker->moveToThread(&mThread);
+	QObject::connect(&mThread, &QThread::finished, mWorker, &QObject::deleteLater);
+	mThread.start(QThread::LowPriority);
+	
+	const QString filePath = Utils::coreStringToAppString(Paths::getMessageSearchIndexFilePath());
+	QMetaObject::invokeMethod(mWorker, [this, filePath] {
+		mAvailable = openDatabase(filePath);
+	}, Qt::BlockingQueuedConnection);
+	
+	mBackfillTimer.setInterval(BackfillInterval);
+	QObject::connect(&mBackfillTimer, &QTimer::timeout, this, &MessageSearchIndex::handleBackfillTimeout);
+}
+
+MessageSearchIndex::~MessageSearchIndex () {
+	// Wait for the queued requests and the close before stopping the thread.
+	QMetaObject::invokeMethod(mWorker, &MessageSearchIndex::closeDatabase, Qt::BlockingQueuedConnection);
+	mThread.quit();
+	mThread.wait();
+	mInstance = nullptr;
+}
+
+MessageSearchIndex *MessageSearchIndex::getInstance () {
+	if (!mInstance)
+		mInstance = new MessageSearchIndex(QCoreApplication::instance());
+	return mInstance;
+}
+
+bool MessageSearchIndex::isAvailable () const {
+	return mAvailable;
+}
+
+void MessageSearchIndex::runInWorker (const std::function<void()> &function) {
+	QMetaObject::invokeMethod(mWorker, function, Qt::QueuedConnection);
+}
+
+// -----------------------------------------------------------------------------
+
+void MessageSearchIndex::addMessage (const std::shared_ptr<linphone::ChatMessage> &message) {
+	if (!mAvailable)
+		return;
+	Document document;
+	const bool hasDocument = createDocument(message, document);
+	
+	// The history of an indexed chat room stays indexed up to its newest message.
+	QString peerAddress, localAddress;
+	int count = -1;
+	auto chatRoom = message->getChatRoom();
+	if (chatRoom) {
+		peerAddress = getPeerAddress(chatRoom);
+		localAddress = getLocalAddress(chatRoom);
+		const QString key = getChatRoomKey(peerAddress, localAddress);
+		if (mIndexedChatRooms.contains(key))
+			count = ++mBackfillCounts[key];
+		else if (mBackfillCountsLoaded && !mBackfillChatRooms.contains(chatRoom)) {// Chat room created after the start of the backfill.
+			mBackfillChatRooms << chatRoom;
+			mBackfillTimer.start();
+		}
+	}
+	if (!hasDocument && count < 0)
+		return;
+	runInWorker([hasDocument, document, peerAddress, localAddress, count] {
+		if (hasDocument)
+			insertDocuments({ document });
+		if (count >= 0)
+			setBackfillCount(peerAddress, localAddress, count);
+	});
+}
+
+void MessageSearchIndex::removeMessage (const std::shared_ptr<linphone::ChatMessage> &message) {
+	const QString messageId = Utils::coreStringToAppString(message->getMessageId());
+	if (!mAvailable || messageId.isEmpty())
+		return;
+	
+	// The history is shorter: backfill one message less to not skip the newest one.
+	QString peerAddress, localAddress;
+	int count = -1;
+	auto chatRoom = message->getChatRoom();
+	if (chatRoom) {
+		peerAddress = getPeerAddress(chatRoom);
+		localAddress = getLocalAddress(chatRoom);
+		auto it = mBackfillCounts.find(getChatRoomKey(peerAddress, localAddress));
+		if (it != mBackfillCounts.end())
+			count = *it = qMax(0, *it - 1);
+	}
+	runInWorker([messageId, peerAddress, localAddress, count] {
+		removeDocument(messageId);
+		if (count >= 0)
+			setBackfillCount(peerAddress, localAddress, count);
+	});
+}
+
+void MessageSearchIndex::removeChatRoom (const std::shared_ptr<linphone::ChatRoom> &chatRoom) {
+	if (!mAvailable || !chatRoom)
+		return;
+	const QString peerAddress = getPeerAddress(chatRoom);
+	const QString localAddress = getLocalAddress(chatRoom);
+	const QString key = getChatRoomKey(peerAddress, localAddress);
+	mBackfillCounts.remove(key);
+	mIndexedChatRooms.remove(key);
+	mBackfillChatRooms.removeAll(chatRoom);
+	runInWorker([peerAddress, localAddress] {
+		removeDocuments(peerAddress, localAddress);
+	});
+}
+
+void MessageSearchIndex::startBackfill () {
+	if (!mAvailable || mBackfillTimer.isActive())
+		return;
+	runInWorker([this] {
+		const QHash<QString, int> counts = getBackfillCounts();
+		QMetaObject::invokeMethod(this, [this, counts] {
+			if (!CoreManager::isInstanciated() || !CoreManager::getInstance()->getCore())
+				return;
+			mBackfillCounts = counts;
+			mBackfillCountsLoaded = true;
+			mIndexedChatRooms.clear();
+			mBackfillChatRooms.clear();
+			for (const auto &chatRoom : CoreManager::getInstance()->getCore()->getChatRooms())
+				mBackfillChatRooms << chatRoom;
+			mBackfillTimer.start();
+		}, Qt::QueuedConnection);
+	});
+}
+
+bool MessageSearchIndex::isIndexed (const std::shared_ptr<linphone::ChatRoom> &chatRoom) const {
+	return mAvailable && chatRoom && mIndexedChatRooms.contains(getChatRoomKey(getPeerAddress(chatRoom), getLocalAddress(chatRoom)));
+}
+
+int MessageSearchIndex::search (const QString &text, const QString &peerAddress, const QString &localAddress, int limit) {
+	const int requestId = ++mLastRequestId;
+	const QString match = getMatchExpression(text);
+	runInWorker([this, requestId, match, peerAddress, localAddress, limit] {
+		const QVector<Result> results = match.isEmpty() ? QVector<Result>() : find(match, peerAddress, localAddress, limit);
+		QMetaObject::invokeMethod(this, [this, requestId, results] {
+			emit searchFinished(requestId, results);
+		}, Qt::QueuedConnection);
+	});
+	return requestId;
+}
+
+// -----------------------------------------------------------------------------
+
+// Index batches of the oldest messages of the chat rooms that are not indexed yet.
+// New messages don't move the oldest ones in the history.
+// The core is not thread-safe : its history can only be read here, so each timeout reads small batches
+// within a time budget. Writes are done by the worker.
+void MessageSearchIndex::handleBackfillTimeout () {
+	QElapsedTimer elapsedTimer;
+	elapsedTimer.start();
+	while (!mBackfillChatRooms.isEmpty()) {
+		if (elapsedTimer.hasExpired(BackfillTimeBudget))
+			return;
+		const std::shared_ptr<linphone::ChatRoom> chatRoom = mBackfillChatRooms.first();
+		const QString peerAddress = getPeerAddress(chatRoom);
+		const QString localAddress = getLocalAddress(chatRoom);
+		const QString key = getChatRoomKey(peerAddress, localAddress);
+		const int historySize = chatRoom->getHistorySize();
+		const int count = mBackfillCounts.value(key);
+		if (count >= historySize) {
+			mIndexedChatRooms << key;
+			mBackfillChatRooms.removeFirst();
+			continue;
+		}
+		
+		const int batchSize = qMin(BackfillBatchSize, historySize - count);
+		QVector<Document> documents;
+		Document document;
+		for (const auto &message : chatRoom->getHistoryRange(historySize - count - batchSize, historySize - count))
+			if (createDocument(message, document))
+				documents << document;
+		const int newCount = count + batchSize;
+		mBackfillCounts[key] = newCount;
+		runInWorker([documents, peerAddress, localAddress, newCount] {
+			insertDocuments(documents);
+			setBackfillCount(peerAddress, localAddress, newCount);
+		});
+	}
+	mBackfillTimer.stop();
+	qInfo() << QStringLiteral("Message search index is up to date.");
+}
+
+// -----------------------------------------------------------------------------
+
+bool MessageSearchIndex::createDocument (const std::shared_ptr<linphone::ChatMessage> &message, Document &document) {
+	auto chatRoom = message->getChatRoom();
+	document.messageId = Utils::coreStringToAppString(message->getMessageId());
+	// Ephemeral messages must not outlive their expiration in the index.
+	if (!chatRoom || document.messageId.isEmpty() || message->isEphemeral())
+		return false;
+	
+	document.text.clear();
+	for (const auto &content : message->getContents())
+		if (content->isText())
+			document.text += Utils::coreStringToAppString(content->getUtf8Text());
+	if (document.text.isEmpty())
+		return false;
+	
+	document.peerAddress = getPeerAddress(chatRoom);
+	document.localAddress = getLocalAddress(chatRoom);
+	document.time = message->getTime();
+	return true;
+}
+
+QString MessageSearchIndex::getChatRoomKey (const QString &peerAddress, const QString &localAddress) {
+	return peerAddress + QLatin1Char(' ') + localAddress;
+}
+
+// A phrase of the words of `text`, the last one being a prefix: `"hello wor"*`.
+QString MessageSearchIndex::getMatchExpression (const QString &text) {
+	QString phrase = text.simplified();
+	if (phrase.isEmpty())
+		return QString();
+	return QLatin1Char('"') + phrase.replace(QLatin1Char('"'), QStringLiteral("\"\"")) + QStringLiteral("\"*");
+}
+
+// -----------------------------------------------------------------------------
+// Worker thread.
+// -----------------------------------------------------------------------------
+
+bool MessageSearchIndex::openDatabase (const QString &filePath) {
+	QSqlDatabase database = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), ConnectionName);
+	database.setDatabaseName(filePath);
+	if (!database.open()) {
+		qWarning() << QStringLiteral("Unable to open the message search index `%1`: %2.").arg(filePath).arg(database.lastError().text());
+		return false;
+	}
+	
+	static const char *Statements[] = {
+		"PRAGMA journal_mode = WAL",
+		"PRAGMA synchronous = NORMAL",
+		"CREATE TABLE IF NOT EXISTS documents ("
+			"id INTEGER PRIMARY KEY, message_id TEXT NOT NULL UNIQUE, peer TEXT NOT NULL, local TEXT NOT NULL, time INTEGER NOT NULL"
+		")",
+		"CREATE INDEX IF NOT EXISTS documents_chat_room ON documents (peer, local)",
+		"CREATE VIRTUAL TABLE IF NOT EXISTS messages USING fts5(text, tokenize = 'unicode61')",
+		"CREATE TABLE IF NOT EXISTS backfill ("
+			"peer TEXT NOT NULL, local TEXT NOT NULL, count INTEGER NOT NULL, PRIMARY KEY (peer, local)"
+		")"
+	};
+	QSqlQuery query(database);
+	for (const char *statement : Statements)
+		if (!query.exec(QString::fromLatin1(statement))) {
+			qWarning() << QStringLiteral("Unable to create the message search index: %1.").arg(query.lastError().text());
+			database.close();
+			return false;
+		}
+	qInfo() << QStringLiteral("Message search index opened: `%1`.").arg(filePath);
+	return true;
+}
+
+void MessageSearchIndex::closeDatabase () {
+	{
+		QSqlDatabase database = QSqlDatabase::database(ConnectionName, false);
+		if (database.isOpen())
+			database.close();
+	}
+	QSqlDatabase::removeDatabase(ConnectionName);
+}
+
+void MessageSearchIndex::insertDocuments (const QVector<Document> &documents) {
+	QSqlDatabase database = QSqlDatabase::database(ConnectionName, false);
+	if (!database.isOpen() || documents.isEmpty())
+		return;
+	
+	database.transaction();
+	QSqlQuery insertDocument(database);
+	insertDocument.prepare(QStringLiteral("INSERT OR IGNORE INTO documents (message_id, peer, local, time) VALUES (?, ?, ?, ?)"));
+	QSqlQuery insertText(database);
+	insertText.prepare(QStringLiteral("INSERT INTO messages (rowid, text) VALUES (?, ?)"));
+	for (const Document &document : documents) {
+		insertDocument.addBindValue(document.messageId);
+		insertDocument.addBindValue(document.peerAddress);
+		insertDocument.addBindValue(document.localAddress);
+		insertDocument.addBindValue(document.time);
+		if (!insertDocument.exec() || insertDocument.numRowsAffected() <= 0)
+			continue;// Already indexed.
+		
+		insertText.addBindValue(insertDocument.lastInsertId());
+		insertText.addBindValue(document.text);
+		if (!insertText.exec())
+			qWarning() << QStringLiteral("Unable to index message `%1`: %2.").arg(document.messageId).arg(insertText.lastError().text());
+	}
+	database.commit();
+}
+
+void MessageSearchIndex::removeDocument (const QString &messageId) {
+	QSqlDatabase database = QSqlDatabase::database(ConnectionName, false);
+	if (!database.isOpen())
+		return;
+	
+	database.transaction();
+	QSqlQuery query(database);
+	query.prepare(QStringLiteral("DELETE FROM messages WHERE rowid IN (SELECT id FROM documents WHERE message_id = ?)"));
+	query.addBindValue(messageId);
+	query.exec();
+	query.prepare(QStringLiteral("DELETE FROM documents WHERE message_id = ?"));
+	query.addBindValue(messageId);
+	query.exec();
+	database.commit();
+}
+
+void MessageSearchIndex::removeDocuments (const QString &peerAddress, const QString &localAddress) {
+	QSqlDatabase database = QSqlDatabase::database(ConnectionName, false);
+	if (!database.isOpen())
+		return;
+	
+	database.transaction();
+	QSqlQuery query(database);
+	for (const QString &statement : {
+		QStringLiteral("DELETE FROM messages WHERE rowid IN (SELECT id FROM documents WHERE peer = ? AND local = ?)"),
+		QStringLiteral("DELETE FROM documents WHERE peer = ? AND local = ?"),
+		QStringLiteral("DELETE FROM backfill WHERE peer = ? AND local = ?")
+	}) {
+		query.prepare(statement);
+		query.addBindValue(peerAddress);
+		query.addBindValue(localAddress);
+		query.exec();
+	}
+	database.commit();
+}
+
+void MessageSearchIndex::setBackfillCount (const QString &peerAddress, const QString &localAddress, int count) {
+	QSqlDatabase database = QSqlDatabase::database(ConnectionName, false);
+	if (!database.isOpen())
+		return;
+	
+	QSqlQuery query(database);
+	query.prepare(QStringLiteral("INSERT OR REPLACE INTO backfill (peer, local, count) VALUES (?, ?, ?)"));
+	query.addBindValue(peerAddress);
+	query.addBindValue(localAddress);
+	query.addBindValue(count);
+	query.exec();
+}
+
+QHash<QString, int> MessageSearchIndex::getBackfillCounts () {
+	QHash<QString, int> counts;
+	QSqlDatabase database = QSqlDatabase::database(ConnectionName, false);
+	if (!database.isOpen())
+		return counts;
+	
+	QSqlQuery query(database);
+	if (query.exec(QStringLiteral("SELECT peer, local, count FROM backfill")))
+		while (query.next())
+			counts[getChatRoomKey(query.value(0).toString(), query.value(1).toString())] = query.value(2).toInt();
+	return counts;
+}
+
+QVector<MessageSearchIndex::Result> MessageSearchIndex::find (
+	const QString &match,
+	const QString &peerAddress,
+	const QString &localAddress,
+	int limit
+) {
+	QVector<Result> results;
+	QSqlDatabase database = QSqlDatabase::database(ConnectionName, false);
+	if (!database.isOpen())
+		return results;
+	
+	QSqlQuery query(database);
+	query.prepare(QStringLiteral(
+		"SELECT documents.message_id, documents.peer, documents.local, documents.time, snippet(messages, 0, '', '', '...', 12) "
+		"FROM messages JOIN documents ON documents.id = messages.rowid "
+		"WHERE messages MATCH ? %1"
+		"ORDER BY bm25(messages) LIMIT ?"
+	).arg(peerAddress.isEmpty() ? QString() : QStringLiteral("AND documents.peer = ? AND documents.local = ? ")));
+	query.addBindValue(match);
+	if (!peerAddress.isEmpty()) {
+		query.addBindValue(peerAddress);
+		query.addBindValue(localAddress);
+	}
+	query.addBindValue(limit);
+	if (!query.exec()) {
+		qWarning() << QStringLiteral("Unable to search `%1` in messages: %2.").arg(match).arg(query.lastError().text());
+		return results;
+	}
+	
+	while (query.next())
+		results << Result{
+			query.value(0).toString(),
+			query.value(1).toString(),
+			query.value(2).toString(),
+			QDateTime::fromMSecsSinceEpoch(query.value(3).toLongLong() * 1000),
+			query.value(4).toString()
+		};
+	return results;
+}
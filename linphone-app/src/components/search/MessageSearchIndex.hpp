@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2022 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef MESSAGE_SEARCH_INDEX_H_
+#define MESSAGE_SEARCH_INDEX_H_
+
+#include <functional>
+#include <memory>
+
+#include <QDateTime>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+
+// =============================================================================
+// Full-text index of the messages of all chat rooms, stored in a SQLite FTS5
+// database. It is fed with sent and received messages, backfilled in the
+// background from the history and queried in a worker thread.
+// =============================================================================
+
+namespace linphone {
+	class ChatMessage;
+	class ChatRoom;
+}
+
+class MessageSearchIndex : public QObject {
+	Q_OBJECT
+	
+public:
+	struct Result {
+		QString messageId;
+		QString peerAddress;
+		QString localAddress;
+		QDateTime time;
+		QString snippet;
+	};
+	
+	static constexpr int DefaultLimit = 50;
+	
+	static MessageSearchIndex *getInstance ();
+	
+	// False if the index can't be opened (no FTS5 support).
+	bool isAvailable () const;
+	
+	void addMessage (const std::shared_ptr<linphone::ChatMessage> &message);
+	void removeMessage (const std::shared_ptr<linphone::ChatMessage> &message);
+	void removeChatRoom (const std::shared_ptr<linphone::ChatRoom> &chatRoom);
+	
+	// Index the history of all chat rooms, by small batches on the GUI thread.
+	void startBackfill ();
+	// True when the whole history of the chat room is indexed. Until then, searches can miss its messages.
+	bool isIndexed (const std::shared_ptr<linphone::ChatRoom> &chatRoom) const;
+	
+	// Results are ranked by relevance and limited to a chat room if `peerAddress` is set.
+	// Return the id of the request, given in `searchFinished`.
+	int search (const QString &text, const QString &peerAddress = QString(), const QString &localAddress = QString(), int limit = DefaultLimit);
+	
+signals:
+	void searchFinished (int requestId, const QVector<MessageSearchIndex::Result> &results);
+	
+private:
+	struct Document {
+		QString messageId;
+		QString peerAddress;
+		QString localAddress;
+		qint64 time;
+		QString text;
+	};
+	
+	MessageSearchIndex (QObject *parent = Q_NULLPTR);
+	~MessageSearchIndex ();
+	
+	void runInWorker (const std::function<void()> &function);
+	
+	void handleBackfillTimeout ();
+	
+	static bool createDocument (const std::shared_ptr<linphone::ChatMessage> &message, Document &document);
+	static QString getChatRoomKey (const QString &peerAddress, const QString &localAddress);
+	static QString getMatchExpression (const QString &text);
+	
+	// Worker thread.
+	static bool openDatabase (const QString &filePath);
+	static void closeDatabase ();
+	static void insertDocuments (const QVector<Document> &documents);
+	static void removeDocument (const QString &messageId);
+	static void removeDocuments (const QString &peerAddress, const QString &localAddress);
+	static void setBackfillCount (const QString &peerAddress, const QString &localAddress, int count);
+	static QHash<QString, int> getBackfillCounts ();
+	static QVector<Result> find (const QString &match, const QString &peerAddress, const QString &localAddress, int limit);
+	
+	QThread mThread;
+	QObject *mWorker = nullptr;
+	bool mAvailable = false;
+	int mLastRequestId = 0;
+	
+	QTimer mBackfillTimer;
+	QList<std::shared_ptr<linphone::ChatRoom>> mBackfillChatRooms;
+	QHash<QString, int> mBackfillCounts;	// Oldest messages already indexed, by chat room.
+	QSet<QString> mIndexedChatRooms;	// Chat rooms whose backfill is done.
+	bool mBackfillCountsLoaded = false;
+	
+	static MessageSearchIndex *mInstance;
+};
+
+#endif // MESSAGE_SEARCH_INDEX_H_
@@ -24,6 +24,7 @@
 #include "config.h"
 
 #include "app/paths/Paths.hpp"
+#include "app/tracer/Tracer.hpp"
 #include "components/core/CoreHandlers.hpp"
 #include "components/core/CoreManager.hpp"
 #include "utils/Utils.hpp"
@@ -57,6 +58,7 @@ static inline AccountSettingsModel::RegistrationState mapLinphoneRegistrationSta
 // -----------------------------------------------------------------------------
 
 AccountSettingsModel::AccountSettingsModel (QObject *parent) : QObject(parent) {
+	Tracer::Span span("AccountSettingsModel::AccountSettingsModel");
 	CoreManager *coreManager = CoreManager::getInstance();
 	QObject::connect(
 				coreManager->getHandlers().get(), &CoreHandlers::registrationStateChanged,
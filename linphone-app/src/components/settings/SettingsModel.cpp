@@ -31,6 +31,7 @@
 #include "app/App.hpp"
 #include "app/logger/Logger.hpp"
 #include "app/paths/Paths.hpp"
+#include "app/tracer/Tracer.hpp"
 #include "components/core/CoreManager.hpp"
 #include "components/tunnel/TunnelModel.hpp"
 #include "include/LinphoneApp/PluginNetworkHelper.hpp"
@@ -48,6 +49,7 @@ const string SettingsModel::UiSection("ui");
 const string SettingsModel::ContactsSection("contacts_import");
 
 SettingsModel::SettingsModel (QObject *parent) : QObject(parent) {
+	Tracer::Span span("SettingsModel::SettingsModel");
 	CoreManager *coreManager = CoreManager::getInstance();
 	mConfig = coreManager->getCore()->getConfig();
 
@@ -1452,6 +1454,34 @@ void SettingsModel::setUseMinimalTimelineFilter(const bool& useMinimal) {
 	emit useMinimalTimelineFilterChanged();
 }
 
+int SettingsModel::getNotificationsPoolSize() const{
+	return mConfig->getInt(UiSection, "notifications_pool_size", 5);
+}
+
+int SettingsModel::getNotificationsPoolWarmUp() const{
+	return mConfig->getInt(UiSection, "notifications_pool_warm_up", 0);
+}
+
+int SettingsModel::getNotificationsBurstDelay() const{
+	return mConfig->getInt(UiSection, "notifications_burst_delay", 1000);
+}
+
+int SettingsModel::getEventCountUpdateInterval() const{
+	return mConfig->getInt(UiSection, "event_count_update_interval", 500);
+}
+
+int SettingsModel::getCallStatsHistoryDuration() const{
+	return mConfig->getInt(UiSection, "call_stats_history_duration", 300);
+}
+
+bool SettingsModel::getCallStatsRecordingEnabled() const{
+	return !!mConfig->getInt(UiSection, "call_stats_recording_enabled", 0);
+}
+
+int SettingsModel::getChatResidentMemoryLimit() const{
+	return mConfig->getInt(UiSection, "chat_resident_memory_limit", 16384);
+}
+
 // =============================================================================
 // Advanced.
 // =============================================================================
@@ -538,6 +538,14 @@ public:
 	bool useMinimalTimelineFilter() const;
 	void setUseMinimalTimelineFilter(const bool& useMinimal);
 	
+	int getNotificationsPoolSize() const;	// Max idle notification views kept per screen and type.
+	int getNotificationsPoolWarmUp() const;	// Views created ahead per screen for messages and calls.
+	int getNotificationsBurstDelay() const;	// Window (ms) used to aggregate received messages by chat room. 0 to disable.
+	int getEventCountUpdateInterval() const;	// Min interval (ms) between two event count (badge) updates.
+	int getCallStatsHistoryDuration() const;	// Duration (s) of call stats kept per stream for trends.
+	bool getCallStatsRecordingEnabled() const;	// Record the stats of each call in the call stats folder.
+	int getChatResidentMemoryLimit() const;	// Memory (KB) of loaded entries by chat room. Entries far from the view are released over it. 0 to disable.
+	
 	// Advanced. ---------------------------------------------------------------------------
 	
 	
@@ -23,6 +23,7 @@
 #include <QUrl>
 #include <QtDebug>
 
+#include "app/tracer/Tracer.hpp"
 #include "components/call/CallModel.hpp"
 #include "components/chat-room/ChatRoomModel.hpp"
 #include "components/contact/ContactModel.hpp"
@@ -52,6 +53,7 @@ static inline QVariantMap buildVariantMap (const SipAddressesModel::SipAddressEn
 }
 
 SipAddressesModel::SipAddressesModel (QObject *parent) : QAbstractListModel(parent) {
+	Tracer::Span span("SipAddressesModel::SipAddressesModel");
 	initSipAddresses();
 	
 	CoreManager *coreManager = CoreManager::getInstance();
@@ -573,6 +575,7 @@ void SipAddressesModel::removeContactOfSipAddress (const QString &sipAddress) {
 // -----------------------------------------------------------------------------
 
 void SipAddressesModel::initSipAddresses () {
+	Tracer::Span span("SipAddressesModel::initSipAddresses");
 	QElapsedTimer timer, stepsTimer;
 	timer.start();
 	
@@ -26,6 +26,7 @@
 #include "utils/Utils.hpp"
 
 #include "SoundPlayer.hpp"
+#include "WaveformExtractor.hpp"
 
 // =============================================================================
 
@@ -68,6 +69,10 @@ SoundPlayer::SoundPlayer (QObject *parent) : QObject(parent) {
 	QObject::connect(settingsModel, &SettingsModel::ringerDeviceChanged, this, [this] {
 		rebuildInternalPlayer();
 	});
+	QObject::connect(WaveformExtractor::getInstance(), &WaveformExtractor::waveformExtracted, this, [this](const QString &filePath) {
+		if (filePath == mSource)
+			emit waveformChanged();
+	});
 	buildInternalPlayer();
 }
 
@@ -131,6 +136,11 @@ int SoundPlayer::getPosition () const {
 	return mInternalPlayer->getCurrentPosition();
 }
 
+QVariantList SoundPlayer::getWaveform (int count) const {
+	auto waveform = WaveformExtractor::getInstance()->getWaveform(mSource);
+	return waveform ? WaveformExtractor::getPeaks(*waveform, count) : QVariantList();
+}
+
 // -----------------------------------------------------------------------------
 
 void SoundPlayer::buildInternalPlayer () {
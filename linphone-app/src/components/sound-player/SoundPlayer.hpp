@@ -25,6 +25,7 @@
 
 #include <QMutex>
 #include <QObject>
+#include <QVariantList>
 
 // =============================================================================
 
@@ -64,8 +65,12 @@ public:
 	
 	Q_INVOKABLE int getPosition () const;
 	
+	// `count` peaks between 0 and 1 of the source. Empty while the waveform is extracted in background.
+	Q_INVOKABLE QVariantList getWaveform (int count) const;
+	
 signals:
 	void sourceChanged (const QString &source);
+	void waveformChanged ();
 	
 	void paused ();
 	void playing ();
@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2022 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <atomic>
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include <QtConcurrent>
+#include <QtDebug>
+
+#include <linphone/linphonecore.h>
+#include <mediastreamer2/allfilters.h>
+#include <mediastreamer2/msfactory.h>
+#include <mediastreamer2/msfileplayer.h>
+#include <mediastreamer2/msfilter.h>
+#include <mediastreamer2/msticker.h>
+
+#include "app/paths/Paths.hpp"
+#include "components/core/CoreManager.hpp"
+#include "utils/Utils.hpp"
+
+#include "WaveformExtractor.hpp"
+
+// =============================================================================
+
+namespace {
+	constexpr quint32 FileMagic = 0x4C575046;	// "LWPF".
+	constexpr quint16 FileVersion = 1;
+	constexpr char FileSuffix[] = ".peaks";
+	
+	constexpr int MinLevelSize = 32;
+	constexpr int MaxDuration = 3600 * 1000;	// In ms. Longer files are truncated.
+	constexpr int ExtractionTimeout = 30000;	// In ms.
+	constexpr int CacheSize = 4 * 1024 * 1024;	// In bytes.
+	
+	// Peaks computation of the decoded samples. Written from the ticker thread.
+	struct Extraction {
+		int rate = 0;
+		int channels = 1;
+		int blockSamples = 0;
+		int blockPosition = 0;
+		int blockPeak = 0;
+		QByteArray peaks;
+		std::atomic<bool> eof { false };
+	};
+	
+	void addSamples (Extraction *extraction, const int16_t *samples, int count) {
+		for (int i = 0; i < count; ++i) {
+			extraction->blockPeak = qMax(extraction->blockPeak, std::abs(int(samples[i])));
+			if (++extraction->blockPosition == extraction->blockSamples) {
+				extraction->peaks.append(char(quint8(qMin(255, extraction->blockPeak >> 7))));
+				extraction->blockPosition = 0;
+				extraction->blockPeak = 0;
+			}
+		}
+	}
+	
+	void peaksSinkProcess (MSFilter *f) {
+		Extraction *extraction = static_cast<Extraction *>(f->data);
+		mblk_t *m;
+		while ((m = ms_queue_get(f->inputs[0]))) {
+			if (extraction && extraction->blockSamples > 0 && extraction->peaks.size() < MaxDuration / WaveformExtractor::BlockDuration)
+				addSamples(extraction, reinterpret_cast<const int16_t *>(m->b_rptr), int(m->b_wptr - m->b_rptr) / int(sizeof(int16_t)));
+			freemsg(m);
+		}
+	}
+	
+	MSFilterDesc createPeaksSinkDesc () {
+		MSFilterDesc desc = {};
+		desc.id = MS_FILTER_PLUGIN_ID;
+		desc.name = "WaveformPeaksSink";
+		desc.text = "Compute the peaks of the waveforms.";
+		desc.category = MS_FILTER_OTHER;
+		desc.ninputs = 1;
+		desc.noutputs = 0;
+		desc.process = peaksSinkProcess;
+		return desc;
+	}
+	
+	MSFilterDesc PeaksSinkDesc = createPeaksSinkDesc();
+	
+	void handlePlayerEvent (void *userData, MSFilter *, unsigned int id, void *) {
+		if (id == MS_PLAYER_EOF)
+			static_cast<Extraction *>(userData)->eof = true;
+	}
+	
+	// Virtual time : ticks run back to back instead of following the wall clock.
+	uint64_t getTickerTime (void *userData) {
+		return static_cast<MSTicker *>(userData)->time;
+	}
+	
+	// Find the output pin of the audio track.
+	int getAudioPin (MSFilter *player, MSPinFormat &pinFormat) {
+		for (int pin = 0; pin < player->desc->noutputs; ++pin) {
+			pinFormat.pin = pin;
+			pinFormat.fmt = nullptr;
+			if (ms_filter_call_method(player, MS_FILTER_GET_OUTPUT_FMT, &pinFormat) == 0 && pinFormat.fmt && pinFormat.fmt->type == MSAudio)
+				return pin;
+		}
+		return -1;
+	}
+}
+
+constexpr int WaveformExtractor::BlockDuration;
+
+WaveformExtractor *WaveformExtractor::mInstance = nullptr;
+
+// -----------------------------------------------------------------------------
+
+WaveformExtractor::WaveformExtractor (QObject *parent) : QObject(parent) {
+	mWaveforms.setMaxCost(CacheSize);
+}
+
+WaveformExtractor *WaveformExtractor::getInstance () {
+	if (!mInstance)
+		mInstance = new WaveformExtractor(QCoreApplication::instance());
+	return mInstance;
+}
+
+std::shared_ptr<const WaveformExtractor::Waveform> WaveformExtractor::getWaveform (const QString &filePath) {
+	if (filePath.isEmpty())
+		return nullptr;
+	std::shared_ptr<const Waveform> *waveform = mWaveforms.object(filePath);
+	if (waveform)
+		return *waveform;
+	if (!mPendingFiles.contains(filePath)) {
+		mPendingFiles << filePath;
+		_MSFactory *factory = linphone_core_get_ms_factory(CoreManager::getInstance()->getCore()->cPtr());
+		QtConcurrent::run([this, factory, filePath] {
+			std::shared_ptr<const Waveform> waveform = load(filePath);
+			if (!waveform) {
+				waveform = extract(factory, filePath);
+				if (waveform)
+					save(filePath, *waveform);
+			}
+			QMetaObject::invokeMethod(this, [this, filePath, waveform] {
+				handleWaveformExtracted(filePath, waveform);
+			}, Qt::QueuedConnection);
+		});
+	}
+	return nullptr;
+}
+
+void WaveformExtractor::removeWaveform (const QString &filePath) {
+	mWaveforms.remove(filePath);
+	QFile::remove(getCacheFilePath(filePath));
+}
+
+QVariantList WaveformExtractor::getPeaks (const Waveform &waveform, int count) {
+	QVariantList peaks;
+	if (count <= 0 || waveform.levels.isEmpty() || waveform.levels[0].isEmpty())
+		return peaks;
+	// The coarsest level that has enough peaks.
+	int level = 0;
+	while (level + 1 < waveform.levels.size() && waveform.levels[level + 1].size() >= count)
+		++level;
+	const QByteArray &levelPeaks = waveform.levels[level];
+	const int size = levelPeaks.size();
+	peaks.reserve(count);
+	for (int i = 0; i < count; ++i) {
+		const int begin = int(qint64(i) * size / count);
+		const int end = qMax(begin + 1, int(qint64(i + 1) * size / count));
+		quint8 peak = 0;
+		for (int j = begin; j < end && j < size; ++j)
+			peak = qMax(peak, quint8(levelPeaks[j]));
+		peaks << peak / 255.0;
+	}
+	return peaks;
+}
+
+void WaveformExtractor::handleWaveformExtracted (const QString &filePath, std::shared_ptr<const Waveform> waveform) {
+	mPendingFiles.remove(filePath);
+	if (!waveform)
+		return;
+	int cost = 0;
+	for (const QByteArray &level : waveform->levels)
+		cost += level.size();
+	mWaveforms.insert(filePath, new std::shared_ptr<const Waveform>(waveform), cost);
+	emit waveformExtracted(filePath);
+}
+
+// -----------------------------------------------------------------------------
+
+QString WaveformExtractor::getCacheFilePath (const QString &filePath) {
+	return Utils::coreStringToAppString(Paths::getThumbnailsDirPath())
+		+ QString::fromLatin1(QCryptographicHash::hash(filePath.toUtf8(), QCryptographicHash::Sha1).toHex())
+		+ FileSuffix;
+}
+
+// The cache is valid while the file is not modified.
+std::shared_ptr<const WaveformExtractor::Waveform> WaveformExtractor::load (const QString &filePath) {
+	QFile file(getCacheFilePath(filePath));
+	if (!file.open(QIODevice::ReadOnly))
+		return nullptr;
+	QFileInfo fileInfo(filePath);
+	QDataStream stream(&file);
+	stream.setByteOrder(QDataStream::LittleEndian);
+	quint32 magic;
+	quint16 version, blockDuration;
+	qint64 size, lastModified;
+	quint8 levelCount;
+	stream >> magic >> version >> blockDuration >> size >> lastModified >> levelCount;
+	if (stream.status() != QDataStream::Ok || magic != FileMagic || version != FileVersion || blockDuration != BlockDuration
+		|| size != fileInfo.size() || lastModified != fileInfo.lastModified().toMSecsSinceEpoch())
+		return nullptr;
+	auto waveform = std::make_shared<Waveform>();
+	for (int i = 0; i < levelCount; ++i) {
+		QByteArray level;
+		stream >> level;
+		waveform->levels << level;
+	}
+	if (stream.status() != QDataStream::Ok)
+		return nullptr;
+	return waveform;
+}
+
+bool WaveformExtractor::save (const QString &filePath, const Waveform &waveform) {
+	QFile file(getCacheFilePath(filePath));
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		qWarning() << QStringLiteral("Unable to save waveform: `%1`.").arg(file.fileName());
+		return false;
+	}
+	QFileInfo fileInfo(filePath);
+	QDataStream stream(&file);
+	stream.setByteOrder(QDataStream::LittleEndian);
+	stream << FileMagic << FileVersion << quint16(BlockDuration) << qint64(fileInfo.size())
+		<< qint64(fileInfo.lastModified().toMSecsSinceEpoch()) << quint8(waveform.levels.size());
+	for (const QByteArray &level : waveform.levels)
+		stream << level;
+	return stream.status() == QDataStream::Ok;
+}
+
+// Decode the file with a mediastreamer graph : player -> decoder (if needed) -> peaks sink.
+std::shared_ptr<const WaveformExtractor::Waveform> WaveformExtractor::extract (_MSFactory *factory, const QString &filePath) {
+	QElapsedTimer timer;
+	timer.start();
+	
+	const bool isWav = filePath.endsWith(".wav", Qt::CaseInsensitive);
+	const std::string path = Utils::appStringToCoreString(filePath);
+	Extraction extraction;
+	MSFilter *player = ms_factory_create_filter(factory, isWav ? MS_FILE_PLAYER_ID : MS_MKV_PLAYER_ID);
+	if (!player)
+		return nullptr;
+	ms_filter_add_notify_callback(player, handlePlayerEvent, &extraction, TRUE);
+	if (ms_filter_call_method(player, MS_PLAYER_OPEN, const_cast<char *>(path.c_str())) != 0) {
+		qWarning() << QStringLiteral("Unable to open audio file for its waveform: `%1`.").arg(filePath);
+		ms_filter_destroy(player);
+		return nullptr;
+	}
+	
+	int pin = 0;
+	MSFilter *decoder = nullptr;
+	if (isWav) {
+		ms_filter_call_method(player, MS_FILTER_GET_SAMPLE_RATE, &extraction.rate);
+		ms_filter_call_method(player, MS_FILTER_GET_NCHANNELS, &extraction.channels);
+	} else {
+		MSPinFormat pinFormat = {};
+		pin = getAudioPin(player, pinFormat);
+		if (pin >= 0)
+			decoder = ms_factory_create_decoder(factory, pinFormat.fmt->encoding);
+		if (!decoder) {
+			qWarning() << QStringLiteral("No audio track to decode in: `%1`.").arg(filePath);
+			ms_filter_call_method_noarg(player, MS_PLAYER_CLOSE);
+			ms_filter_destroy(player);
+			return nullptr;
+		}
+		int rate = pinFormat.fmt->rate;
+		int channels = pinFormat.fmt->nchannels;
+		ms_filter_call_method(decoder, MS_FILTER_SET_SAMPLE_RATE, &rate);
+		ms_filter_call_method(decoder, MS_FILTER_SET_NCHANNELS, &channels);
+		extraction.rate = rate;
+		extraction.channels = channels;
+		ms_filter_call_method(decoder, MS_FILTER_GET_SAMPLE_RATE, &extraction.rate);
+	}
+	extraction.blockSamples = extraction.rate * qMax(1, extraction.channels) * BlockDuration / 1000;
+	
+	MSFilter *sink = ms_factory_create_filter_from_desc(factory, &PeaksSinkDesc);
+	sink->data = &extraction;
+	if (decoder) {
+		ms_filter_link(player, pin, decoder, 0);
+		ms_filter_link(decoder, 0, sink, 0);
+	} else
+		ms_filter_link(player, pin, sink, 0);
+	
+	MSTicker *ticker = ms_ticker_new();
+	ms_ticker_set_time_func(ticker, getTickerTime, ticker);
+	ms_filter_call_method_noarg(player, MS_PLAYER_START);
+	ms_ticker_attach(ticker, player);
+	while (!extraction.eof && timer.elapsed() < ExtractionTimeout)
+		QThread::msleep(5);
+	ms_ticker_detach(ticker, player);
+	
+	if (decoder) {
+		ms_filter_unlink(player, pin, decoder, 0);
+		ms_filter_unlink(decoder, 0, sink, 0);
+		ms_filter_destroy(decoder);
+	} else
+		ms_filter_unlink(player, pin, sink, 0);
+	sink->data = nullptr;
+	ms_filter_destroy(sink);
+	ms_filter_call_method_noarg(player, MS_PLAYER_CLOSE);
+	ms_filter_destroy(player);
+	ms_ticker_destroy(ticker);
+	
+	if (!extraction.eof)
+		qWarning() << QStringLiteral("Waveform extraction timed out: `%1`.").arg(filePath);
+	if (extraction.peaks.isEmpty())
+		return nullptr;
+	
+	auto waveform = std::make_shared<Waveform>();
+	waveform->levels << extraction.peaks;
+	while (waveform->levels.last().size() / 2 >= MinLevelSize) {
+		const QByteArray &previous = waveform->levels.last();
+		QByteArray level(previous.size() / 2, 0);
+		for (int i = 0; i < level.size(); ++i)
+			level[i] = char(qMax(quint8(previous[2 * i]), quint8(previous[2 * i + 1])));
+		waveform->levels << level;
+	}
+	qInfo() << QStringLiteral("Waveform of `%1` extracted in %2 ms (%3 peaks).").arg(filePath).arg(timer.elapsed()).arg(extraction.peaks.size());
+	return waveform;
+}
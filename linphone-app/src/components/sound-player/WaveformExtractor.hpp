@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2022 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WAVEFORM_EXTRACTOR_H_
+#define WAVEFORM_EXTRACTOR_H_
+
+#include <memory>
+
+#include <QCache>
+#include <QObject>
+#include <QSet>
+#include <QVariantList>
+#include <QVector>
+
+// =============================================================================
+// Peaks of audio files (voice recordings), decoded once in background.
+// A waveform has several resolutions : level 0 has one peak per
+// `BlockDuration` ms and each next level halves the previous one. Waveforms
+// are cached in memory and in the thumbnails folder.
+// =============================================================================
+
+struct _MSFactory;
+
+class WaveformExtractor : public QObject {
+	Q_OBJECT
+	
+public:
+	struct Waveform {
+		QVector<QByteArray> levels;	// Peaks between 0 and 255.
+	};
+	
+	static constexpr int BlockDuration = 10;	// In ms.
+	
+	static WaveformExtractor *getInstance ();
+	
+	// Return the waveform of `filePath` if it's known. Otherwise, start its extraction and return null.
+	// `waveformExtracted` is emitted when it's done.
+	std::shared_ptr<const Waveform> getWaveform (const QString &filePath);
+	
+	// Remove the cached waveform of `filePath`.
+	void removeWaveform (const QString &filePath);
+	
+	// `count` peaks between 0 and 1 of the whole file, from the closest level.
+	static QVariantList getPeaks (const Waveform &waveform, int count);
+	
+signals:
+	void waveformExtracted (const QString &filePath);
+	
+private:
+	WaveformExtractor (QObject *parent = Q_NULLPTR);
+	
+	void handleWaveformExtracted (const QString &filePath, std::shared_ptr<const Waveform> waveform);
+	
+	static QString getCacheFilePath (const QString &filePath);
+	static std::shared_ptr<const Waveform> load (const QString &filePath);
+	static bool save (const QString &filePath, const Waveform &waveform);
+	static std::shared_ptr<const Waveform> extract (_MSFactory *factory, const QString &filePath);
+	
+	QCache<QString, std::shared_ptr<const Waveform>> mWaveforms;
+	QSet<QString> mPendingFiles;
+	
+	static WaveformExtractor *mInstance;
+};
+
+#endif // WAVEFORM_EXTRACTOR_H_
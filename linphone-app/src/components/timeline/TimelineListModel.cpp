@@ -20,6 +20,7 @@
 
 #include "TimelineListModel.hpp"
 
+#include "app/tracer/Tracer.hpp"
 #include "components/core/CoreManager.hpp"
 #include "components/core/CoreHandlers.hpp"
 #include "components/calls/CallsListModel.hpp"
@@ -39,11 +40,12 @@
 // =============================================================================
 
 TimelineListModel::TimelineListModel (QObject *parent) : ProxyListModel(parent) {
+	Tracer::Span span("TimelineListModel::TimelineListModel");
+	setRowIndexEnabled(true);
 	mSelectedCount = 0;
 	CoreHandlers* coreHandlers= CoreManager::getInstance()->getHandlers().get();
 	connect(coreHandlers, &CoreHandlers::chatRoomStateChanged, this, &TimelineListModel::onChatRoomStateChanged);
 	connect(coreHandlers, &CoreHandlers::messageReceived, this, &TimelineListModel::update);
-	connect(coreHandlers, &CoreHandlers::messageReceived, this, &TimelineListModel::updated);
 	
 	QObject::connect(coreHandlers, &CoreHandlers::callStateChanged, this, &TimelineListModel::onCallStateChanged);
 	QObject::connect(coreHandlers, &CoreHandlers::callCreated, this, &TimelineListModel::onCallCreated);
@@ -265,12 +267,26 @@ void TimelineListModel::updateTimelines () {
 }
 
 void TimelineListModel::add (QSharedPointer<TimelineModel> timeline){
-	connect(timeline->getChatRoomModel(), &ChatRoomModel::lastUpdateTimeChanged, this, &TimelineListModel::updated);
+	TimelineModel *timelineModel = timeline.get();
+	auto onSortDataChanged = [this, timelineModel]() {
+		onTimelineDataChanged(timelineModel);
+	};
+	// Sort keys of the proxy : only the row of the timeline is moved.
+	connect(timeline->getChatRoomModel(), &ChatRoomModel::lastUpdateTimeChanged, timelineModel, onSortDataChanged);
+	connect(timeline->getChatRoomModel(), &ChatRoomModel::unreadMessagesCountChanged, timelineModel, onSortDataChanged);
+	connect(timeline->getChatRoomModel(), &ChatRoomModel::missedCallsCountChanged, timelineModel, onSortDataChanged);
 	ProxyListModel::add(timeline);
-	emit layoutChanged();
 	emit countChanged();
 }
 
+void TimelineListModel::onTimelineDataChanged(TimelineModel *timeline){
+	int row = indexOf(timeline);
+	if(row >= 0){
+		QModelIndex modelIndex = index(row, 0);
+		emit dataChanged(modelIndex, modelIndex);
+	}
+}
+
 void TimelineListModel::removeChatRoomModel(QSharedPointer<ChatRoomModel> model){
 	if(!model || (model->getChatRoom()->isEmpty() && (model->isReadOnly() || !model->isGroupEnabled()))){
 		auto itTimeline = mList.begin();
@@ -63,12 +63,12 @@ public slots:
 	void onChatRoomStateChanged(const std::shared_ptr<linphone::ChatRoom> &chatRoom,linphone::ChatRoom::State state);
 	void onCallStateChanged (const std::shared_ptr<linphone::Call> &call, linphone::Call::State state) ;
 	void onCallCreated(const std::shared_ptr<linphone::Call> &call);
+	void onTimelineDataChanged(TimelineModel *timeline);
 	
 signals:
 	void countChanged();
 	void selectedCountChanged(int selectedCount);
 	void selectedChanged(TimelineModel * timelineModel);
-	void updated();
 
 private:
 	virtual bool removeRows (int row, int count, const QModelIndex &parent) override;
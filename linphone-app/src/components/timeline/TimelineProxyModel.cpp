@@ -18,6 +18,7 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "app/tracer/ModelStats.hpp"
 #include "components/core/CoreManager.hpp"
 #include "components/participant/ParticipantListModel.hpp"
 #include "components/settings/AccountSettingsModel.hpp"
@@ -37,12 +38,12 @@
 // -----------------------------------------------------------------------------
 
 TimelineProxyModel::TimelineProxyModel (QObject *parent) : QSortFilterProxyModel(parent) {
+	ModelStats::watch(this);
 	CoreManager *coreManager = CoreManager::getInstance();
 	AccountSettingsModel *accountSettingsModel = coreManager->getAccountSettingsModel();
 	TimelineListModel * model = CoreManager::getInstance()->getTimelineListModel();
 	
 	connect(model, SIGNAL(selectedCountChanged(int)), this, SIGNAL(selectedCountChanged(int)));
-	connect(model, &TimelineListModel::updated, this, &TimelineProxyModel::invalidate);
 	connect(model, &TimelineListModel::selectedChanged, this, &TimelineProxyModel::selectedChanged);
 	connect(model, &TimelineListModel::countChanged, this, &TimelineProxyModel::countChanged);
 
@@ -82,6 +83,7 @@ void TimelineProxyModel::setFilterText(const QString& text){
 // -----------------------------------------------------------------------------
 
 bool TimelineProxyModel::filterAcceptsRow (int sourceRow, const QModelIndex &sourceParent) const {
+	ModelStats::Scope scope(this, ModelStats::FilterTiming);
 	const QModelIndex index = sourceModel()->index(sourceRow, 0, sourceParent);
 	auto timeline = sourceModel()->data(index).value<TimelineModel*>();
 	if(!timeline || !timeline->getChatRoomModel() || timeline->getChatRoomModel()->getState() == (int)linphone::ChatRoom::State::Terminated)
@@ -116,6 +118,7 @@ bool TimelineProxyModel::filterAcceptsRow (int sourceRow, const QModelIndex &sou
 }
 
 bool TimelineProxyModel::lessThan (const QModelIndex &left, const QModelIndex &right) const {
+	ModelStats::Scope scope(this, ModelStats::SortTiming);
 	const TimelineModel* a = sourceModel()->data(left).value<TimelineModel*>();
 	const TimelineModel* b = sourceModel()->data(right).value<TimelineModel*>();
 	bool aHaveUnread = a->getChatRoomModel()->getAllUnreadCount() > 0;
@@ -29,6 +29,7 @@
 #cmakedefine APPLICATION_SEMVER "${APPLICATION_SEMVER}"
 #cmakedefine COPYRIGHT_RANGE_DATE "${COPYRIGHT_RANGE_DATE}"
 #cmakedefine ENABLE_UPDATE_CHECK 1
+#cmakedefine ENABLE_BZIP2 1
 #cmakedefine EXECUTABLE_NAME "${EXECUTABLE_NAME}"
 #cmakedefine MSPLUGINS_DIR "${MSPLUGINS_DIR}"
 #cmakedefine ENABLE_APP_WEBVIEW "${ENABLE_APP_WEBVIEW}"
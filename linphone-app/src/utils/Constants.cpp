@@ -30,6 +30,7 @@ constexpr char Constants::SrcPattern[];
 
 constexpr char Constants::PathAssistantConfig[];
 constexpr char Constants::PathAvatars[];
+constexpr char Constants::PathCallStats[];
 constexpr char Constants::PathCaptures[];
 constexpr char Constants::PathCodecs[];
 constexpr char Constants::PathData[];
@@ -53,6 +54,7 @@ constexpr char Constants::PathRootCa[];
 constexpr char Constants::PathFriendsList[];
 constexpr char Constants::PathLimeDatabase[];
 constexpr char Constants::PathMessageHistoryList[];
+constexpr char Constants::PathMessageSearchIndex[];
 constexpr char Constants::PathZrtpSecrets[];
 
 // Max image size in bytes. (100Kb)
@@ -92,6 +92,7 @@ public:
 
 	static constexpr char PathAssistantConfig[] = "/" EXECUTABLE_NAME "/assistant/";
 	static constexpr char PathAvatars[] = "/avatars/";
+	static constexpr char PathCallStats[] = "/call-stats/";
 	static constexpr char PathCaptures[] = "/" EXECUTABLE_NAME "/captures/";
 	static constexpr char PathCodecs[] =  "/codecs/";
 	static constexpr char PathData[] =  "/" EXECUTABLE_NAME;
@@ -115,6 +116,7 @@ public:
 	static constexpr char PathFriendsList[] = "/friends.db";
 	static constexpr char PathLimeDatabase[] = "/x3dh.c25519.sqlite3";
 	static constexpr char PathMessageHistoryList[] = "/message-history.db";
+	static constexpr char PathMessageSearchIndex[] = "/message-search.db";
 	static constexpr char PathZrtpSecrets[] = "/zidcache";
 	
 	static constexpr char LanguagePath[] = ":/languages/";
@@ -29,12 +29,88 @@
 
 using namespace MediastreamerUtils;
 
+namespace {
+	// Levels are computed on 16 bits samples.
+	void levelTapProcess(MSFilter *f) {
+		LevelMeter *meter = static_cast<LevelMeter *>(f->data);
+		mblk_t *m;
+		while ((m = ms_queue_get(f->inputs[0]))) {
+			const int16_t *samples = reinterpret_cast<const int16_t *>(m->b_rptr);
+			const int count = int(m->b_wptr - m->b_rptr) / int(sizeof(int16_t));
+			if (meter && count > 0) {
+				double energy = 0.0;
+				int peak = 0;
+				for (int i = 0; i < count; ++i) {
+					const int sample = samples[i];
+					energy += double(sample) * sample;
+					peak = qMax(peak, std::abs(sample));
+				}
+				AudioLevel level;
+				level.rms = float(std::sqrt(energy / count) / 32768.0);
+				level.peak = float(peak / 32768.0);
+				meter->push(level);
+			}
+			ms_queue_put(f->outputs[0], m);
+		}
+	}
+
+	MSFilterDesc createLevelTapDesc() {
+		MSFilterDesc desc = {};
+		desc.id = MS_FILTER_PLUGIN_ID;
+		desc.name = "LevelMeterTap";
+		desc.text = "Push the levels of audio samples into a LevelMeter.";
+		desc.category = MS_FILTER_OTHER;
+		desc.ninputs = 1;
+		desc.noutputs = 1;
+		desc.process = levelTapProcess;
+		return desc;
+	}
+
+	MSFilterDesc LevelTapDesc = createLevelTapDesc();
+}
+
+constexpr unsigned int LevelMeter::Capacity;
+
+MSFilter *LevelMeter::createTap(MSFactory *factory, LevelMeter *meter) {
+	MSFilter *tap = ms_factory_create_filter_from_desc(factory, &LevelTapDesc);
+	if (tap)
+		tap->data = meter;
+	return tap;
+}
+
+void LevelMeter::push(const AudioLevel &level) {
+	const unsigned int head = mHead.load(std::memory_order_relaxed);
+	if (head - mTail.load(std::memory_order_acquire) == Capacity)
+		return;
+	mLevels[head & (Capacity - 1)] = level;
+	mHead.store(head + 1, std::memory_order_release);
+}
+
+bool LevelMeter::pop(AudioLevel &level) {
+	unsigned int tail = mTail.load(std::memory_order_relaxed);
+	const unsigned int head = mHead.load(std::memory_order_acquire);
+	if (tail == head)
+		return false;
+	level = AudioLevel();
+	for (; tail != head; ++tail) {
+		const AudioLevel &pushedLevel = mLevels[tail & (Capacity - 1)];
+		level.rms = qMax(level.rms, pushedLevel.rms);
+		level.peak = qMax(level.peak, pushedLevel.peak);
+	}
+	mTail.store(tail, std::memory_order_release);
+	return true;
+}
+
+// -----------------------------------------------------------------------------
+
 SimpleCaptureGraph::SimpleCaptureGraph(const std::string &capture, const std::string &playback)
-	: captureCardId(capture), playbackCardId(playback)
+	: SimpleCaptureGraph(linphone_core_get_ms_factory(CoreManager::getInstance()->getCore()->cPtr()), capture, playback)
 {
-	LinphoneCore *ccore = CoreManager::getInstance()->getCore()->cPtr();
-	msFactory = linphone_core_get_ms_factory(ccore);
+}
 
+SimpleCaptureGraph::SimpleCaptureGraph(MSFactory *factory, const std::string &capture, const std::string &playback)
+	: captureCardId(capture), playbackCardId(playback), msFactory(factory)
+{
 	playbackCard = ms_snd_card_manager_get_card(ms_factory_get_snd_card_manager(msFactory), playbackCardId.c_str());
 	if (!playbackCard)
 		qWarning("Cannot get playback card from MSFactory with : %s", playbackCardId.c_str());
@@ -66,6 +142,8 @@ void SimpleCaptureGraph::init() {
 	}
 	if(!resamplerFilter)
 		resamplerFilter = ms_factory_create_filter(msFactory, MS_RESAMPLE_ID);
+	if(!levelTapFilter)
+		levelTapFilter = LevelMeter::createTap(msFactory, &levelMeter);
 	int captureRate, playbackRate, captureChannels, playbackChannels;
 	ms_filter_call_method(audioCapture,MS_FILTER_GET_SAMPLE_RATE,&captureRate);
 	ms_filter_call_method(audioSink,MS_FILTER_GET_SAMPLE_RATE,&playbackRate);
@@ -78,7 +156,8 @@ void SimpleCaptureGraph::init() {
 	ms_filter_call_method(resamplerFilter,MS_FILTER_SET_OUTPUT_NCHANNELS,&playbackChannels);
 
 	ms_filter_link(audioCapture, 0, captureVolumeFilter, 0);
-	ms_filter_link(captureVolumeFilter, 0, resamplerFilter, 0);
+	ms_filter_link(captureVolumeFilter, 0, levelTapFilter, 0);
+	ms_filter_link(levelTapFilter, 0, resamplerFilter, 0);
 	ms_filter_link(resamplerFilter, 0, playbackVolumeFilter, 0);
 	ms_filter_link(playbackVolumeFilter, 0, audioSink, 0);
 
@@ -112,8 +191,10 @@ void SimpleCaptureGraph::destroy() {
 	
 	if (audioSink)
 		ms_filter_unlink(playbackVolumeFilter, 0, audioSink, 0);
-	if (captureVolumeFilter && resamplerFilter)
-		ms_filter_unlink(captureVolumeFilter, 0, resamplerFilter, 0);
+	if (captureVolumeFilter && levelTapFilter)
+		ms_filter_unlink(captureVolumeFilter, 0, levelTapFilter, 0);
+	if (levelTapFilter && resamplerFilter)
+		ms_filter_unlink(levelTapFilter, 0, resamplerFilter, 0);
 	if (resamplerFilter && playbackVolumeFilter)
 		ms_filter_unlink(resamplerFilter, 0, playbackVolumeFilter, 0);
 	if (audioCapture)
@@ -124,6 +205,8 @@ void SimpleCaptureGraph::destroy() {
 		ms_filter_destroy(captureVolumeFilter);
 	if (resamplerFilter)
 		ms_filter_destroy(resamplerFilter);
+	if (levelTapFilter)
+		ms_filter_destroy(levelTapFilter);
 	if (audioSink)
 		ms_filter_destroy(audioSink);
 	if (audioCapture)
@@ -135,6 +218,7 @@ void SimpleCaptureGraph::destroy() {
 	playbackVolumeFilter = nullptr;
 	captureVolumeFilter = nullptr;
 	resamplerFilter = nullptr;
+	levelTapFilter = nullptr;
 	audioSink = nullptr;
 	audioCapture = nullptr;
 }
@@ -168,12 +252,16 @@ void SimpleCaptureGraph::setPlaybackGain(float gain) {
 	}
 }
 
+// Energy (mean square), same scale than the former dbToLinear(MS_VOLUME_GET) : pow(10, dB / 10).
 float SimpleCaptureGraph::getCaptureVolume() {
-	float vol = 0;
+	const AudioLevel level = getCaptureLevel();
+	return level.rms * level.rms;
+}
 
-	if (captureVolumeFilter) {
-		ms_filter_call_method(captureVolumeFilter, MS_VOLUME_GET, &vol);
-		vol = MediastreamerUtils::dbToLinear(vol);
-	}
-	return vol;
+// Read from the level meter : no call into the audio graph.
+AudioLevel SimpleCaptureGraph::getCaptureLevel() {
+	if (!isRunning())
+		return AudioLevel();
+	levelMeter.pop(captureLevel);
+	return captureLevel;
 }
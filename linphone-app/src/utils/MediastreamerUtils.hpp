@@ -21,6 +21,7 @@
 #ifndef MEDIASTREAMER_UTILS_H_
 #define MEDIASTREAMER_UTILS_H_
 
+#include <atomic>
 #include <cmath>
 
 #include "mediastreamer2/mssndcard.h"
@@ -58,17 +59,46 @@ namespace MediastreamerUtils {
         return static_cast<float>(10.0 * log10(volume));
 	}
 
+	// Linear levels of audio samples, between 0 and 1.
+	struct AudioLevel {
+		float rms = 0.0f;
+		float peak = 0.0f;
+	};
+
+	// Single-producer/single-consumer lock-free ring of levels. The tap filter pushes
+	// the levels of each block from the audio thread, the GUI reads them at display rate.
+	class LevelMeter {
+	public:
+		static constexpr unsigned int Capacity = 64;// Must be a power of 2.
+
+		// Pass-through filter that pushes levels of the samples it receives into `meter`.
+		static MSFilter *createTap(MSFactory *factory, LevelMeter *meter);
+
+		// Producer. The level is dropped if the ring is full.
+		void push(const AudioLevel &level);
+		// Consumer. Get the max of levels pushed since the last call. Return false if there is none.
+		bool pop(AudioLevel &level);
+
+	private:
+		AudioLevel mLevels[Capacity];
+		std::atomic<unsigned int> mHead{ 0 };// Next write.
+		std::atomic<unsigned int> mTail{ 0 };// Next read.
+	};
+
 	//Simple mediastreamer audio capture graph
 	//Used to get current microphone volume in audio settings
 	class SimpleCaptureGraph {
 	public:
 		SimpleCaptureGraph(const std::string &captureCardId, const std::string &playbackCardId);
+		// Use the cards of `factory` instead of the ones of the core. Used by the audio benchmark.
+		SimpleCaptureGraph(MSFactory *factory, const std::string &captureCardId, const std::string &playbackCardId);
 		~SimpleCaptureGraph();
 
 		void start();
 		void stop();
 
 		float getCaptureVolume();
+		AudioLevel getCaptureLevel();// Max level since the last call, or the last level if there is no new one.
 
 		float getCaptureGain();
 		float getPlaybackGain();
@@ -92,10 +122,14 @@ namespace MediastreamerUtils {
 		MSFilter *captureVolumeFilter = nullptr;
 		MSFilter *playbackVolumeFilter = nullptr;
 		MSFilter *resamplerFilter = nullptr;
+		MSFilter *levelTapFilter = nullptr;
 		MSTicker *ticker = nullptr;
 		MSSndCard *playbackCard = nullptr;
 		MSSndCard *captureCard = nullptr;
 		MSFactory *msFactory = nullptr;
+
+		LevelMeter levelMeter;
+		AudioLevel captureLevel;// Last level read from levelMeter.
 	};
 
 }
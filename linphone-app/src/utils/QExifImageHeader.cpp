@@ -48,6 +48,9 @@
 #include <QDateTime>
 #include <QtDebug>
 #include <QTextCodec>
+#include <QtEndian>
+
+#include <cstring>
 
 #include "Utils.hpp"
 
@@ -878,6 +881,134 @@ bool QExifImageHeader::loadFromJpeg (QIODevice *device) {
   return false;
 }
 
+namespace {
+  // Size read when a file can't be mapped. APP1 segments are limited to 64 KiB.
+  constexpr qint64 OrientationReadSize = 128 * 1024;
+
+  inline quint16 readUInt16 (const uchar *data, bool littleEndian) {
+    return littleEndian ? qFromLittleEndian<quint16>(data) : qFromBigEndian<quint16>(data);
+  }
+
+  inline quint32 readUInt32 (const uchar *data, bool littleEndian) {
+    return littleEndian ? qFromLittleEndian<quint32>(data) : qFromBigEndian<quint32>(data);
+  }
+
+  // Start Of Frame markers, except DHT (C4), JPG (C8) and DAC (CC).
+  inline bool isStartOfFrame (uchar marker) {
+    return marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+  }
+
+  // Read the orientation tag of IFD0 in a TIFF header.
+  int readTiffOrientation (const uchar *tiff, qint64 size) {
+    if (size < 8)
+      return 0;
+
+    bool littleEndian;
+    if (tiff[0] == 'I' && tiff[1] == 'I')
+      littleEndian = true;
+    else if (tiff[0] == 'M' && tiff[1] == 'M')
+      littleEndian = false;
+    else
+      return 0;
+
+    if (readUInt16(tiff + 2, littleEndian) != 42)
+      return 0;
+
+    const qint64 ifdOffset = readUInt32(tiff + 4, littleEndian);
+    if (ifdOffset + 2 > size)
+      return 0;
+
+    const quint16 count = readUInt16(tiff + ifdOffset, littleEndian);
+    for (quint16 i = 0; i < count; ++i) {
+      const qint64 entryOffset = ifdOffset + 2 + 12 * qint64(i);
+      if (entryOffset + 12 > size)
+        return 0;
+
+      const uchar *entry = tiff + entryOffset;
+      const quint16 tag = readUInt16(entry, littleEndian);
+      if (tag == QExifImageHeader::Orientation) {
+        // SHORT value, stored in the first bytes of the value field.
+        const quint16 orientation = readUInt16(entry + 8, littleEndian);
+        return readUInt16(entry + 2, littleEndian) == 3 && orientation <= 8 ? orientation : 0;
+      }
+      if (tag > QExifImageHeader::Orientation)
+        return 0; // Tags are sorted.
+    }
+    return 0;
+  }
+}
+
+/*!
+    Reads only the orientation tag of a JPEG image with the given \a fileName, without building
+    the meta-data. If \a dimensions is not null, it receives the size of the image.
+
+    The file is mapped in memory when possible. Returns 0 if there is no orientation.
+ */
+int QExifImageHeader::readOrientation (const QString &fileName, QSize *dimensions) {
+  QFile file(fileName);
+
+  if (!file.open(QIODevice::ReadOnly))
+    return 0;
+
+  const qint64 size = file.size();
+  if (uchar *data = file.map(0, size)) {
+    const int orientation = readOrientation(data, size, dimensions);
+    file.unmap(data);
+    return orientation;
+  }
+
+  const QByteArray data = file.read(OrientationReadSize);
+  return readOrientation(reinterpret_cast<const uchar *>(data.constData()), data.size(), dimensions);
+}
+
+/*!
+    Reads only the orientation tag of a JPEG image stored in \a data. Only the JPEG markers and
+    the first IFD are walked, without allocation. If \a dimensions is not null, the walk continues
+    to the start of frame to read the size of the image.
+
+    Returns 0 if there is no orientation.
+ */
+int QExifImageHeader::readOrientation (const uchar *data, qint64 size, QSize *dimensions) {
+  if (size < 4 || data[0] != 0xFF || data[1] != 0xD8)
+    return 0;
+
+  int orientation = 0;
+  bool exifFound = false;
+  qint64 pos = 2;
+  while (pos + 4 <= size && data[pos] == 0xFF) {
+    const uchar marker = data[pos + 1];
+    if (marker == 0xFF) {
+      ++pos; // Fill byte.
+      continue;
+    }
+    if (marker == 0xD9 || marker == 0xDA)
+      break; // End of image or start of scan: no more headers.
+    if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) {
+      pos += 2; // Marker without length.
+      continue;
+    }
+
+    const qint64 length = qFromBigEndian<quint16>(data + pos + 2);
+    if (length < 2 || pos + 2 + length > size)
+      break;
+
+    const uchar *segment = data + pos + 4;
+    const qint64 segmentSize = length - 2;
+    if (!exifFound && marker == 0xE1 && segmentSize >= 6 && memcmp(segment, "Exif\0\0", 6) == 0) {
+      exifFound = true;
+      orientation = readTiffOrientation(segment + 6, segmentSize - 6);
+      if (!dimensions)
+        break;
+    } else if (isStartOfFrame(marker)) {
+      if (dimensions && segmentSize >= 5)
+        *dimensions = QSize(qFromBigEndian<quint16>(segment + 3), qFromBigEndian<quint16>(segment + 1));
+      break; // Exif data is always before the frame.
+    }
+    pos += 2 + length;
+  }
+  return orientation;
+}
+
 /*!
     Saves meta-data to a JPEG image with the given \a fileName.
 
@@ -50,6 +50,7 @@
 #include <QVariant>
 #include <QSysInfo>
 #include <QIODevice>
+#include <QSize>
 
 typedef QPair<quint32, quint32> QExifURational;
 typedef QPair<qint32, qint32> QExifSRational;
@@ -263,6 +264,9 @@ public:
 
   bool loadFromJpeg (const QString &fileName);
   bool loadFromJpeg (QIODevice *device);
+
+  static int readOrientation (const QString &fileName, QSize *dimensions = nullptr);
+  static int readOrientation (const uchar *data, qint64 size, QSize *dimensions = nullptr);
   bool saveToJpeg (const QString &fileName) const;
   bool saveToJpeg (QIODevice *device) const;
 
@@ -11,6 +11,25 @@ Popup {
   id: callStatistics
 
   property var call
+  property var _viewedCall: null
+  // ---------------------------------------------------------------------------
+
+  // Stats are only formatted while at least one popup is opened on the call.
+  function _setViewedCall (newCall) {
+    if (_viewedCall === newCall)
+      return
+    if (_viewedCall)
+      _viewedCall.decreaseStatsViewers()
+    _viewedCall = newCall
+    if (_viewedCall)
+      _viewedCall.increaseStatsViewers()
+  }
+
+  onOpened: _setViewedCall(call)
+  onClosed: _setViewedCall(null)
+  onCallChanged: if (visible) _setViewedCall(call)
+  Component.onDestruction: _setViewedCall(null)
+
   // ---------------------------------------------------------------------------
 
   Rectangle {
@@ -47,6 +47,10 @@ function getComponentFromEntry (chatEntry) {
 		return 'Notice.qml'
 	}
 	
+	if (chatEntry.isStub) {// Released message : it is rehydrated when it comes near the view.
+		return 'MessageStub.qml'
+	}
+	
 	return chatEntry.isOutgoing ? 'OutgoingMessage.qml' : 'IncomingMessage.qml'
 }
 
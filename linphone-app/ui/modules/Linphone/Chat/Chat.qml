@@ -74,6 +74,19 @@ Rectangle {
 				running: false
 				onTriggered: if(container.proxyModel.chatRoomModel) container.proxyModel.chatRoomModel.resetMessageCount()
 			}
+			// Entries far from the view are released by the model.
+			onContentYChanged: visibleRangeTimer.restart()
+			onCountChanged: visibleRangeTimer.restart()
+			Timer{
+				id: visibleRangeTimer
+				interval: 200
+				repeat: false
+				onTriggered: {
+					var first = chat.indexAt(chat.width / 2, chat.contentY)
+					var last = chat.indexAt(chat.width / 2, chat.contentY + chat.height - 1)
+					container.proxyModel.setVisibleRange(first < 0 ? 0 : first, last < 0 ? chat.count - 1 : last)
+				}
+			}
 			
 			Layout.fillHeight: true
 			Layout.fillWidth: true
@@ -111,6 +124,7 @@ Rectangle {
 					Logic.handleMoreEntriesLoaded(n)// move view to n - 1 item
 					chat.displaying = false
 				}
+				onSearchMatchLoaded: container.positionViewAtIndex(index)
 			}
 			
 			// -----------------------------------------------------------------------
@@ -269,6 +283,8 @@ Rectangle {
 								asynchronous: true
 								z:1
 							
+								onHeightChanged: if( status == Loader.Ready && height > 0 && !$chatEntry.isStub && $chatEntry.type === ChatRoomModel.MessageEntry)
+													$chatEntry.contentHeight = height	// Kept by the stub if the message is released.
 								onStatusChanged:	if( status == Loader.Ready) {
 														remainingIndex = -1	// overwrite to remove signal changed. That way, there is no more binding loops.
 														--chat.remainingLoadersCount // Loader is ready: remove one from remaining count.
@@ -288,6 +304,7 @@ Rectangle {
 								onReplyClicked: {
 									proxyModel.chatRoomModel.reply = $chatEntry
 								}
+								onHistoryGapClicked: proxyModel.loadGapEntries()
 								onForwardClicked:{
 									window.attachVirtualWindow(Qt.resolvedUrl('../Dialog/SipAddressDialog.qml')
 										//: 'Choose where to forward the message' : Dialog title for choosing where to forward the current message.
@@ -0,0 +1,10 @@
+import QtQuick 2.7
+
+import Linphone.Styles 1.0
+
+// =============================================================================
+// Placeholder of a released message : it keeps the last known height of the message till it is rehydrated.
+
+Item {
+	height: $chatEntry.contentHeight > 0 ? $chatEntry.contentHeight : ChatStyle.entry.lineHeight
+}
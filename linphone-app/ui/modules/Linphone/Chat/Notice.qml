@@ -13,6 +13,8 @@ import ColorsList 1.0
 
 RowLayout{
 	id: mainLayout
+	signal historyGapClicked()
+	
 	property string _type: {
 		var status = $chatEntry.eventLogType
 		var type = $chatEntry.status
@@ -20,6 +22,9 @@ RowLayout{
 		if(type == ChatNoticeModel.NoticeUnreadMessages)
 			//: '%1 unread messages' : Little message to show on an event where unread messages begin.
 			return qsTr('unreadMessageNotice', '', parseInt($chatEntry.name))
+		if(type == ChatNoticeModel.NoticeHistoryGap)
+			//: 'Show newer messages' : Clickable message to show on an event where older messages are not followed by the newest ones.
+			return qsTr('historyGapNotice')
 		
 		if (status == LinphoneEnums.EventLogTypeConferenceCreated) {
 			//: 'You have joined the group' : Little message to show on the event when the user join the chat group.
@@ -116,6 +121,13 @@ RowLayout{
 		verticalAlignment: Text.AlignVCenter
 		TooltipArea {
 		  text: $chatEntry.timestamp.toLocaleString(Qt.locale(App.locale))
+		  visible: $chatEntry.status != ChatNoticeModel.NoticeHistoryGap
+		}
+		MouseArea {
+			anchors.fill: parent
+			visible: $chatEntry.status == ChatNoticeModel.NoticeHistoryGap
+			cursorShape: Qt.PointingHandCursor
+			onClicked: mainLayout.historyGapClicked()
 		}
 	}
 	Rectangle{
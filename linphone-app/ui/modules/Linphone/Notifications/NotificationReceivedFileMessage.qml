@@ -80,7 +80,7 @@ Notification {
 				elide: Text.ElideRight
 				font.pointSize: NotificationReceivedFileMessageStyle.fileSize.pointSize
 				horizontalAlignment: Text.AlignRight
-				text: Utils.formatSize(notification.notificationData.fileSize)
+				text: notification.notificationData && notification.notificationData.fileSize ? Utils.formatSize(notification.notificationData.fileSize) : ''
 			}
 		}
 		
@@ -37,7 +37,7 @@ Notification {
 			
 			Contact {
 				Layout.fillWidth: true
-				property ChatRoomModel chatRoomModel : notification.timelineModel.getChatRoomModel()
+				property ChatRoomModel chatRoomModel : notification.timelineModel ? notification.timelineModel.getChatRoomModel() : null
 				//entry: notification.fullPeerAddress? SipAddressesModel.getSipAddressObserver(notification.fullPeerAddress, notification.fullLocalAddress): notification.timelineModel.getChatRoomModel()
 				property var sipObserver: SipAddressesModel.getSipAddressObserver(notification.fullPeerAddress, notification.fullLocalAddress)		
 				showAuxData: !chatRoomModel.isOneToOne
@@ -74,7 +74,7 @@ Notification {
 					}
 					
 					verticalAlignment: Text.AlignVCenter
-					text: notification.notificationData.message
+					text: notification.notificationData && notification.notificationData.message || ''
 					wrapMode: Text.Wrap
 				}
 			}
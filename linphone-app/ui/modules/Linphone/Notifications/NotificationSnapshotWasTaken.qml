@@ -4,7 +4,7 @@ import Utils 1.0
 
 NotificationBasic {
   icon: 'snapshot_sign'
-  message: Utils.basename(notificationData.filePath)
+  message: notificationData && notificationData.filePath ? Utils.basename(notificationData.filePath) : ''
   handler: (function () {
     Qt.openUrlExternally(Utils.dirname(
       Utils.getUriFromSystemPath(notificationData.filePath)
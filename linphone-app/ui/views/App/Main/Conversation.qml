@@ -519,6 +519,11 @@ ColumnLayout  {
 				placeholderText: qsTr('searchMessagesPlaceholder')
 				
 				onTextChanged: searchDelay.restart()
+				// Browse the matches : older ones with Enter, newer ones with Shift+Enter.
+				Keys.onReturnPressed: if( event.modifiers & Qt.ShiftModifier)
+										chatRoomProxyModel.loadPreviousSearchMatch()
+									else
+										chatRoomProxyModel.loadNextSearchMatch()
 				onIconClicked: {
 					searchView.text = ''
 				}